@@ -0,0 +1,111 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/AsyncSend.h>
+
+#include <memory>
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+AsyncSend::AsyncSend(HandlePool::HandlePtr aHandle, std::shared_ptr<const PreparedRequest> aRequest, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, Completion aCompletion, const PreparedRequest::Headers* headers)
+: handle(std::move(aHandle)),
+  request(std::move(aRequest)),
+  send(*handle, *request, std::move(body), createInput, headers),
+  completion(std::move(aCompletion))
+{ }
+
+AsyncSend::AsyncSend(HandlePool::HandlePtr aHandle, std::shared_ptr<const PreparedRequest> aRequest, Body body, esl::io::Input input, Completion aCompletion, const PreparedRequest::Headers* headers)
+: handle(std::move(aHandle)),
+  request(std::move(aRequest)),
+  send(*handle, *request, std::move(body), std::move(input), headers),
+  completion(std::move(aCompletion))
+{ }
+
+void AsyncSend::setTiming(Timing* aTiming) noexcept {
+	timing = aTiming;
+}
+
+void AsyncSend::setStartCheck(std::function<bool ()> aStartCheck) {
+	startCheck = std::move(aStartCheck);
+}
+
+void AsyncSend::setStartHandler(std::function<bool ()> startHandler) {
+	send.setStartHandler(std::move(startHandler));
+}
+
+void AsyncSend::setRecordCheck(std::function<bool ()> aRecordCheck) {
+	recordCheck = std::move(aRecordCheck);
+}
+
+CURL* AsyncSend::getHandle() const {
+	return handle->curl;
+}
+
+bool AsyncSend::start() {
+	started = !startCheck || startCheck();
+	return started;
+}
+
+bool AsyncSend::resume() {
+	return send.resume();
+}
+
+bool AsyncSend::isPaused() const {
+	return send.isPaused();
+}
+
+bool AsyncSend::drain() {
+	return send.drain();
+}
+
+void AsyncSend::done(CURLcode code) {
+	std::unique_ptr<esl::com::http::client::Response> response;
+	std::exception_ptr exceptionPtr;
+
+	if(timing) {
+		*timing = Timing(handle->curl);
+	}
+
+	if(started && (!recordCheck || recordCheck())) {
+		send.record(code);
+	}
+
+	try {
+		response.reset(new esl::com::http::client::Response(send.complete(code)));
+	}
+	catch(...) {
+		exceptionPtr = std::current_exception();
+	}
+
+	completion(response.get(), exceptionPtr);
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
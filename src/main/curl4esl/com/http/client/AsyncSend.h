@@ -0,0 +1,96 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_ASYNCSEND_H_
+#define CURL4ESL_COM_HTTP_CLIENT_ASYNCSEND_H_
+
+#include <curl4esl/com/http/client/Body.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/MultiEngine.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/Send.h>
+#include <curl4esl/com/http/client/Timing.h>
+
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+
+#include <curl/curl.h>
+
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* A Send running on its own pooled handle, driven by a MultiEngine */
+class AsyncSend : public MultiEngine::Transfer {
+public:
+	/* Called exactly once, either with a response or with an exception */
+	using Completion = std::function<void (const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr)>;
+
+	AsyncSend(HandlePool::HandlePtr handle, std::shared_ptr<const PreparedRequest> request, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, Completion completion, const PreparedRequest::Headers* headers = nullptr);
+	AsyncSend(HandlePool::HandlePtr handle, std::shared_ptr<const PreparedRequest> request, Body body, esl::io::Input input, Completion completion, const PreparedRequest::Headers* headers = nullptr);
+
+	/* 'timing' gets filled before completion is called, it must stay valid until then */
+	void setTiming(Timing* timing) noexcept;
+
+	/* called on the event loop thread, see MultiEngine::Transfer::start() */
+	void setStartCheck(std::function<bool ()> startCheck);
+
+	/* called on the event loop thread, see Send::setStartHandler() */
+	void setStartHandler(std::function<bool ()> startHandler);
+
+	/* Called on the event loop thread when the transfer is done.
+	 * The transfer is recorded in the metrics only if it returns true. */
+	void setRecordCheck(std::function<bool ()> recordCheck);
+
+	CURL* getHandle() const override;
+	bool start() override;
+	bool resume() override;
+	bool isPaused() const override;
+	bool drain() override;
+	void done(CURLcode code) override;
+
+private:
+	/* declared before 'send', so the handle is returned to the pool after 'send' has been destroyed */
+	HandlePool::HandlePtr handle;
+	std::shared_ptr<const PreparedRequest> request;
+	Send send;
+	Completion completion;
+	Timing* timing = nullptr;
+	std::function<bool ()> startCheck;
+	std::function<bool ()> recordCheck;
+	/* a transfer that has not been started by the engine is not recorded, as its handle contains the values of a previous transfer */
+	bool started = false;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_ASYNCSEND_H_ */
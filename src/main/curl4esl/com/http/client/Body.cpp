@@ -0,0 +1,101 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/Body.h>
+
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+Body::Body(esl::io::Output aOutput)
+: type(aOutput ? Type::output : Type::none),
+  output(std::move(aOutput))
+{ }
+
+Body::Body(const void* aData, std::size_t aSize)
+: type(Type::buffer),
+  data(aData),
+  size(aSize)
+{ }
+
+Body::Body(std::shared_ptr<const UploadFile> aFile)
+: type(aFile ? Type::file : Type::none),
+  file(std::move(aFile))
+{ }
+
+Body::Type Body::getType() const noexcept {
+	return type;
+}
+
+bool Body::isRewindable() const noexcept {
+	return type != Type::output;
+}
+
+Body Body::clone() const {
+	if(type == Type::buffer) {
+		return Body(data, size);
+	}
+	if(type == Type::file) {
+		return Body(file);
+	}
+	return Body();
+}
+
+esl::io::Output& Body::getOutput() noexcept {
+	return output;
+}
+
+const void* Body::getData() const noexcept {
+	return data;
+}
+
+std::size_t Body::getSize() const noexcept {
+	return size;
+}
+
+std::size_t Body::readFile(void* data, std::size_t aSize) {
+	std::size_t rv = file->read(data, aSize, filePosition);
+	filePosition += rv;
+	return rv;
+}
+
+bool Body::seekFile(std::uint64_t position) noexcept {
+	if(position > file->getSize()) {
+		return false;
+	}
+	filePosition = position;
+	return true;
+}
+
+std::uint64_t Body::getFileSize() const noexcept {
+	return file->getSize();
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
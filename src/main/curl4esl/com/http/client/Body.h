@@ -0,0 +1,94 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_BODY_H_
+#define CURL4ESL_COM_HTTP_CLIENT_BODY_H_
+
+#include <esl/io/Output.h>
+
+#include <curl4esl/com/http/client/UploadFile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Request body of a Send. It is either pulled from an esl::io::Output,
+ * a contiguous buffer that is handed to libcurl without copying
+ * or a file that is read directly into the upload buffer of libcurl. */
+class Body {
+public:
+	enum class Type {
+		none,
+		output,
+		buffer,
+		file
+	};
+
+	Body() = default;
+	Body(esl::io::Output output);
+
+	/* 'data' must stay valid until the transfer has been completed */
+	Body(const void* data, std::size_t size);
+
+	Body(std::shared_ptr<const UploadFile> file);
+
+	Type getType() const noexcept;
+
+	/* returns true if the body can be sent again by a retry */
+	bool isRewindable() const noexcept;
+
+	/* returns a body that sends the same data again, must only be called if isRewindable() */
+	Body clone() const;
+
+	esl::io::Output& getOutput() noexcept;
+
+	const void* getData() const noexcept;
+	std::size_t getSize() const noexcept;
+
+	/* reads the file at the current position and advances it */
+	std::size_t readFile(void* data, std::size_t size);
+	/* returns false if 'position' is behind the end of the file */
+	bool seekFile(std::uint64_t position) noexcept;
+	std::uint64_t getFileSize() const noexcept;
+
+private:
+	Type type = Type::none;
+	esl::io::Output output;
+	const void* data = nullptr;
+	std::size_t size = 0;
+	std::shared_ptr<const UploadFile> file;
+	std::uint64_t filePosition = 0;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_BODY_H_ */
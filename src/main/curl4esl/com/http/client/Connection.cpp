@@ -21,16 +21,22 @@ SOFTWARE.
 */
 
 #include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/Hedge.h>
 #include <curl4esl/com/http/client/Send.h>
 
 #include <esl/Logger.h>
 
 #include <esl/com/http/client/Response.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <sstream>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 namespace curl4esl {
 inline namespace v1_6 {
@@ -42,37 +48,474 @@ namespace {
 esl::Logger logger("curl4esl::com::http::client::Connection");
 }  // anonymer namespace
 
-Connection::Connection(CURL* aCurl, std::string aHostUrl)
-: curl(aCurl),
-  hostUrl(aHostUrl)
-{ }
+std::atomic<std::uint64_t> Connection::lastId(0);
+thread_local std::unordered_map<std::uint64_t, Connection::ThreadEntry> Connection::threadEntries;
+
+Connection::Connection(std::shared_ptr<HandlePool> aHandlePool, std::shared_ptr<MultiEngine> aMultiEngine, std::string aHostUrl, bool aMultiplex, bool aShared)
+: handlePool(std::move(aHandlePool)),
+  multiEngine(std::move(aMultiEngine)),
+  hostUrl(aHostUrl),
+  multiplex(aMultiplex),
+  shared(aShared),
+  id(++lastId),
+  threadStates(shared ? std::make_shared<ThreadStates>() : nullptr)
+{
+	if(!multiplex && !shared) {
+		ownState.handle = handlePool->acquire();
+	}
+}
 
 Connection::~Connection() {
-    curl_easy_cleanup(curl);
+	if(shared) {
+		threadEntries.erase(id);
+
+		/* handles of other threads go back to the pool as well, their thread local entries expire */
+		std::unordered_map<const ThreadState*, std::unique_ptr<ThreadState>> states;
+		{
+			std::lock_guard<std::mutex> lock(threadStates->mutex);
+			states.swap(threadStates->states);
+		}
+	}
 }
 
 esl::com::http::client::Response Connection::send(const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const {
-	std::string requestUrl = hostUrl;
-	if(request.getPath().empty() == false && request.getPath().at(0) != '/') {
-		requestUrl += "/";
+	RequestScope requestScope(*this, request);
+	return execute(requestScope.get(), Body(std::move(output)), createInput, nullptr);
+}
+
+esl::com::http::client::Response Connection::send(const esl::com::http::client::Request& request, esl::io::Output output, esl::io::Input input) const {
+	RequestScope requestScope(*this, request);
+	return execute(requestScope.get(), Body(std::move(output)), std::move(input));
+}
+
+esl::com::http::client::Response Connection::send(const esl::com::http::client::Request& request, const void* data, std::size_t size, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const {
+	RequestScope requestScope(*this, request);
+	return execute(requestScope.get(), Body(data, size), createInput, nullptr);
+}
+
+esl::com::http::client::Response Connection::send(const esl::com::http::client::Request& request, const void* data, std::size_t size, esl::io::Input input) const {
+	RequestScope requestScope(*this, request);
+	return execute(requestScope.get(), Body(data, size), std::move(input));
+}
+
+esl::com::http::client::Response Connection::send(const esl::com::http::client::Request& request, std::shared_ptr<const UploadFile> file, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const {
+	RequestScope requestScope(*this, request);
+	return execute(requestScope.get(), Body(std::move(file)), createInput, nullptr);
+}
+
+esl::com::http::client::Response Connection::send(const esl::com::http::client::Request& request, std::shared_ptr<const UploadFile> file, esl::io::Input input) const {
+	RequestScope requestScope(*this, request);
+	return execute(requestScope.get(), Body(std::move(file)), std::move(input));
+}
+
+Timing Connection::getTiming() const {
+	ThreadState& threadState = getThreadState();
+	if(multiplex || threadState.lastSendOnEngine) {
+		return threadState.engineTiming;
 	}
-	requestUrl += request.getPath();
+	return Timing(threadState.handle->curl);
+}
 
-	Send send(curl, request, requestUrl, output, createInput);
-	return send.execute();
+PreparedRequest Connection::prepare(const esl::com::http::client::Request& request) const {
+	return PreparedRequest(hostUrl, request);
 }
 
-esl::com::http::client::Response Connection::send(const esl::com::http::client::Request& request, esl::io::Output output, esl::io::Input input) const {
-	std::string requestUrl = hostUrl;
-	if(request.getPath().empty() == false && request.getPath().at(0) != '/') {
-		requestUrl += "/";
+esl::com::http::client::Response Connection::send(const PreparedRequest& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers& headers) const {
+	return execute(request, Body(std::move(output)), createInput, &headers);
+}
+
+esl::com::http::client::Response Connection::send(const PreparedRequest& request, const void* data, std::size_t size, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers& headers) const {
+	return execute(request, Body(data, size), createInput, &headers);
+}
+
+esl::com::http::client::Response Connection::send(const PreparedRequest& request, std::shared_ptr<const UploadFile> file, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers& headers) const {
+	return execute(request, Body(std::move(file)), createInput, &headers);
+}
+
+void Connection::sendAsync(const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, Completion completion, Timing* timing) const {
+	std::shared_ptr<const PreparedRequest> preparedRequest = std::make_shared<PreparedRequest>(hostUrl, request);
+	Body body(std::move(output));
+
+	if(isHedged(*preparedRequest, body)) {
+		Hedge::start(handlePool, multiEngine, std::move(preparedRequest), createInput, std::move(completion), nullptr, timing);
+		return;
+	}
+
+	std::unique_ptr<AsyncSend> transfer(new AsyncSend(handlePool->acquire(), std::move(preparedRequest), std::move(body), createInput, std::move(completion)));
+	transfer->setTiming(timing);
+	multiEngine->add(std::move(transfer));
+}
+
+std::future<esl::com::http::client::Response> Connection::sendAsync(const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const {
+	Completion completion;
+	std::future<esl::com::http::client::Response> future = createFuture(completion);
+
+	sendAsync(request, std::move(output), createInput, std::move(completion));
+	return future;
+}
+
+SegmentedDownload::Result Connection::download(const esl::com::http::client::Request& request, const std::string& path, std::size_t segments) const {
+	SegmentedDownload segmentedDownload(handlePool, multiEngine, std::make_shared<PreparedRequest>(hostUrl, request), path);
+	return segmentedDownload.execute(segments);
+}
+
+void Connection::sendAsync(SocketEngine& socketEngine, const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, Completion completion, Timing* timing) const {
+	std::unique_ptr<AsyncSend> transfer(new AsyncSend(handlePool->acquire(), std::make_shared<PreparedRequest>(hostUrl, request), Body(std::move(output)), createInput, std::move(completion)));
+	transfer->setTiming(timing);
+	socketEngine.add(std::move(transfer));
+}
+
+std::vector<Connection::BatchResult> Connection::sendBatch(std::vector<BatchRequest> requests, std::size_t concurrency) const {
+	if(concurrency == 0) {
+		concurrency = handlePool->getSettings().batchConcurrency;
+	}
+
+	std::shared_ptr<Batch> batch = std::make_shared<Batch>(std::move(requests), handlePool, multiEngine, hostUrl);
+	for(std::size_t i = 0; i < concurrency; ++i) {
+		if(!batch->startNext()) {
+			break;
+		}
+	}
+
+	return batch->wait();
+}
+
+Connection::Batch::Batch(std::vector<BatchRequest> aRequests, std::shared_ptr<HandlePool> aHandlePool, std::shared_ptr<MultiEngine> aMultiEngine, const std::string& aHostUrl)
+: requests(std::move(aRequests)),
+  results(requests.size()),
+  handlePool(std::move(aHandlePool)),
+  multiEngine(std::move(aMultiEngine)),
+  hostUrl(aHostUrl)
+{ }
+
+bool Connection::Batch::startNext() {
+	while(true) {
+		std::size_t index;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(nextIndex == requests.size()) {
+				return false;
+			}
+			index = nextIndex++;
+		}
+
+		try {
+			BatchRequest& batchRequest = requests[index];
+			std::shared_ptr<Batch> batch = shared_from_this();
+			std::unique_ptr<AsyncSend> transfer(new AsyncSend(handlePool->acquire(), std::make_shared<PreparedRequest>(hostUrl, batchRequest.request), std::move(batchRequest.output), batchRequest.createInput,
+					[batch, index](const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr) {
+				batch->done(index, response, exceptionPtr);
+			}));
+			transfer->setTiming(&results[index].timing);
+			multiEngine->add(std::move(transfer));
+			return true;
+		}
+		catch(...) {
+			/* the transfer has not been queued, so the next request is tried instead of recursing through its completion */
+			results[index].exceptionPtr = std::current_exception();
+			if(complete()) {
+				return false;
+			}
+		}
+	}
+}
+
+void Connection::Batch::done(std::size_t index, const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr) {
+	if(response) {
+		results[index].response.reset(new esl::com::http::client::Response(*response));
+	}
+	else {
+		results[index].exceptionPtr = exceptionPtr;
 	}
-	requestUrl += request.getPath();
 
-	Send send(curl, request, requestUrl, output, std::move(input));
-	return send.execute();
+	/* the next transfer is only queued to the event loop, it is not started within this completion */
+	startNext();
+	complete();
 }
 
+bool Connection::Batch::complete() {
+	std::lock_guard<std::mutex> lock(mutex);
+	++completed;
+	if(completed < requests.size()) {
+		return false;
+	}
+
+	/* notify while locked as the last action, sendBatch may return immediately afterwards */
+	condition.notify_all();
+	return true;
+}
+
+std::vector<Connection::BatchResult> Connection::Batch::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this] {
+		return completed == requests.size();
+	});
+
+	return std::move(results);
+}
+
+esl::com::http::client::Response Connection::execute(const PreparedRequest& request, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers) const {
+	if(isCached(request, body, headers)) {
+		return executeCached(request, createInput, headers);
+	}
+	return executeUncached(request, std::move(body), createInput, headers);
+}
+
+esl::com::http::client::Response Connection::execute(const PreparedRequest& request, Body body, esl::io::Input input) const {
+	if(isCached(request, body, nullptr)) {
+		/* the input gets the body of a fresh or a cached response, as if it would have been returned by createInput */
+		std::shared_ptr<esl::io::Input> inputPtr = std::make_shared<esl::io::Input>(std::move(input));
+		return executeCached(request, [inputPtr](const esl::com::http::client::Response&) {
+			return std::move(*inputPtr);
+		}, nullptr);
+	}
+	return executeUncached(request, std::move(body), std::move(input));
+}
+
+esl::com::http::client::Response Connection::executeCached(const PreparedRequest& request, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers) const {
+	ResponseCache& responseCache = handlePool->getResponseCache();
+
+	std::shared_ptr<const ResponseCache::Entry> entry = responseCache.find(request, headers);
+	if(entry && entry->isFresh(std::chrono::steady_clock::now()) && !ResponseCache::isRevalidationRequired(request, headers)) {
+		return responseCache.replay(*entry, createInput);
+	}
+
+	PreparedRequest::Headers conditionalHeaders;
+	if(headers) {
+		conditionalHeaders = *headers;
+	}
+	if(entry) {
+		if(!entry->etag.empty()) {
+			conditionalHeaders.emplace_back("If-None-Match", entry->etag);
+		}
+		if(!entry->lastModified.empty()) {
+			conditionalHeaders.emplace_back("If-Modified-Since", entry->lastModified);
+		}
+	}
+
+	std::shared_ptr<ResponseCache::Capture> capture = std::make_shared<ResponseCache::Capture>();
+	capture->maxSize = responseCache.getMaxEntrySize();
+
+	esl::com::http::client::Response response = executeUncached(request, Body(), [&createInput, capture](const esl::com::http::client::Response& response) {
+		esl::io::Input input = createInput(response);
+		if(!input || response.getStatusCode() != 200) {
+			return input;
+		}
+
+		capture->teed = true;
+		return esl::io::Input(std::unique_ptr<esl::io::Writer>(new ResponseCache::CaptureWriter(std::move(input), capture)));
+	}, &conditionalHeaders);
+
+	if(entry && response.getStatusCode() == 304) {
+		return responseCache.replay(*responseCache.refresh(entry, response), createInput);
+	}
+
+	responseCache.store(request, headers, response, *capture);
+	return response;
+}
+
+esl::com::http::client::Response Connection::executeUncached(const PreparedRequest& request, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers) const {
+	if(isHedged(request, body)) {
+		Completion completion;
+		std::future<esl::com::http::client::Response> future = createFuture(completion);
+
+		/* 'request' is not owned, but this call waits until both sends have been completed */
+		std::shared_ptr<const PreparedRequest> requestPtr(std::shared_ptr<const PreparedRequest>(), &request);
+		ThreadState& threadState = getThreadState();
+		Hedge::start(handlePool, multiEngine, requestPtr, createInput, std::move(completion), headers, &threadState.engineTiming);
+		threadState.lastSendOnEngine = true;
+		return future.get();
+	}
+
+	if(multiplex) {
+		Completion completion;
+		std::future<esl::com::http::client::Response> future = createFuture(completion);
+
+		/* 'request' is not owned, but this call waits until the transfer has been completed */
+		std::shared_ptr<const PreparedRequest> requestPtr(std::shared_ptr<const PreparedRequest>(), &request);
+		std::unique_ptr<AsyncSend> transfer(new AsyncSend(handlePool->acquire(), requestPtr, std::move(body), createInput, std::move(completion), headers));
+		transfer->setTiming(&getThreadState().engineTiming);
+		multiEngine->add(std::move(transfer));
+		return future.get();
+	}
+
+	ThreadState& threadState = getThreadState();
+	threadState.lastSendOnEngine = false;
+	HandlePool::Handle& handle = *threadState.handle;
+
+	RetryPolicy& retryPolicy = handlePool->getRetryPolicy();
+	if(!retryPolicy.isEnabled() || !body.isRewindable()) {
+		Send send(handle, request, std::move(body), createInput, headers);
+		return send.execute();
+	}
+
+	retryPolicy.recordRequest();
+	for(std::size_t attempt = 1;; ++attempt) {
+		bool mayRetry = retryPolicy.mayRetry(attempt);
+
+		Send send(handle, request, mayRetry ? body.clone() : std::move(body), createInput, headers);
+		if(mayRetry) {
+			send.setRetryPolicy(&retryPolicy);
+		}
+
+		CURLcode rc = send.perform();
+		if(!send.isRetryable(rc)) {
+			return send.complete(rc);
+		}
+
+		retryPolicy.recordRetry();
+		std::this_thread::sleep_for(retryPolicy.getBackoff(attempt));
+	}
+}
+
+esl::com::http::client::Response Connection::executeUncached(const PreparedRequest& request, Body body, esl::io::Input input) const {
+	if(multiplex) {
+		Completion completion;
+		std::future<esl::com::http::client::Response> future = createFuture(completion);
+
+		/* 'request' is not owned, but this call waits until the transfer has been completed */
+		std::shared_ptr<const PreparedRequest> requestPtr(std::shared_ptr<const PreparedRequest>(), &request);
+		std::unique_ptr<AsyncSend> transfer(new AsyncSend(handlePool->acquire(), requestPtr, std::move(body), std::move(input), std::move(completion)));
+		transfer->setTiming(&getThreadState().engineTiming);
+		multiEngine->add(std::move(transfer));
+		return future.get();
+	}
+
+	ThreadState& threadState = getThreadState();
+	threadState.lastSendOnEngine = false;
+	HandlePool::Handle& handle = *threadState.handle;
+
+	RetryPolicy& retryPolicy = handlePool->getRetryPolicy();
+	if(!retryPolicy.isEnabled() || !body.isRewindable()) {
+		Send send(handle, request, std::move(body), std::move(input));
+		return send.execute();
+	}
+
+	retryPolicy.recordRequest();
+	for(std::size_t attempt = 1;; ++attempt) {
+		bool mayRetry = retryPolicy.mayRetry(attempt);
+
+		Send send(handle, request, mayRetry ? body.clone() : std::move(body), std::move(input));
+		if(mayRetry) {
+			send.setRetryPolicy(&retryPolicy);
+		}
+
+		CURLcode rc = send.perform();
+		if(!send.isRetryable(rc)) {
+			return send.complete(rc);
+		}
+
+		/* 'input' has not been used, so it is passed to the next attempt */
+		input = send.releaseInput();
+
+		retryPolicy.recordRetry();
+		std::this_thread::sleep_for(retryPolicy.getBackoff(attempt));
+	}
+}
+
+Connection::RequestScope::RequestScope(const Connection& connection, const esl::com::http::client::Request& request)
+: threadState(connection.getThreadState())
+{
+	if(threadState.requestInUse) {
+		ownRequest.reset(new PreparedRequest(connection.hostUrl, request));
+		return;
+	}
+
+	threadState.request.assign(connection.hostUrl, request);
+	threadState.requestInUse = true;
+}
+
+Connection::RequestScope::~RequestScope() {
+	if(!ownRequest) {
+		threadState.requestInUse = false;
+	}
+}
+
+const PreparedRequest& Connection::RequestScope::get() const noexcept {
+	return ownRequest ? *ownRequest : threadState.request;
+}
+
+Connection::ThreadState& Connection::getThreadState() const {
+	if(!shared) {
+		return ownState;
+	}
+
+	auto iter = threadEntries.find(id);
+	if(iter != threadEntries.end()) {
+		return *iter->second.state;
+	}
+
+	/* first send of this thread, so drop the entries of connections that have been destroyed meanwhile */
+	for(auto entryIter = threadEntries.begin(); entryIter != threadEntries.end();) {
+		if(entryIter->second.owner.expired()) {
+			entryIter = threadEntries.erase(entryIter);
+		}
+		else {
+			++entryIter;
+		}
+	}
+
+	std::unique_ptr<ThreadState> state(new ThreadState);
+	if(!multiplex) {
+		state->handle = handlePool->acquire();
+	}
+
+	ThreadEntry& entry = threadEntries[id];
+	entry.owner = threadStates;
+	entry.state = state.get();
+
+	std::lock_guard<std::mutex> lock(threadStates->mutex);
+	threadStates->states[entry.state] = std::move(state);
+	return *entry.state;
+}
+
+Connection::ThreadEntry::~ThreadEntry() {
+	std::shared_ptr<ThreadStates> threadStates = owner.lock();
+	if(!threadStates) {
+		return;
+	}
+
+	/* the handle is released without holding the lock */
+	std::unique_ptr<ThreadState> releasing;
+	{
+		std::lock_guard<std::mutex> lock(threadStates->mutex);
+		auto iter = threadStates->states.find(state);
+		if(iter != threadStates->states.end()) {
+			releasing = std::move(iter->second);
+			threadStates->states.erase(iter);
+		}
+	}
+}
+
+bool Connection::isCached(const PreparedRequest& request, const Body& body, const PreparedRequest::Headers* headers) const {
+	return body.getType() == Body::Type::none && handlePool->getResponseCache().isEnabled() && ResponseCache::isCacheable(request, headers);
+}
+
+bool Connection::isHedged(const PreparedRequest& request, const Body& body) const {
+	return body.getType() == Body::Type::none && request.getMethod() == "GET" && handlePool->getHedgePolicy().isEnabled();
+}
+
+std::future<esl::com::http::client::Response> Connection::createFuture(Completion& completion) {
+	std::shared_ptr<std::promise<esl::com::http::client::Response>> promise = std::make_shared<std::promise<esl::com::http::client::Response>>();
+
+	completion = [promise](const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr) {
+		if(response) {
+			promise->set_value(*response);
+		}
+		else {
+			promise->set_exception(exceptionPtr);
+		}
+	};
+
+	return promise->get_future();
+}
+
+Connection::BatchRequest::BatchRequest(const esl::com::http::client::Request& aRequest, esl::io::Output aOutput, std::function<esl::io::Input (const esl::com::http::client::Response&)> aCreateInput)
+: request(aRequest),
+  output(std::move(aOutput)),
+  createInput(aCreateInput)
+{ }
+
 } /* namespace client */
 } /* namespace http */
 } /* namespace com */
@@ -29,10 +29,28 @@ SOFTWARE.
 #include <esl/io/Input.h>
 #include <esl/io/Output.h>
 
-#include <curl/curl.h>
+#include <curl4esl/com/http/client/AsyncSend.h>
+#include <curl4esl/com/http/client/Body.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/MultiEngine.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/SegmentedDownload.h>
+#include <curl4esl/com/http/client/SocketEngine.h>
+#include <curl4esl/com/http/client/Timing.h>
+#include <curl4esl/com/http/client/UploadFile.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace curl4esl {
 inline namespace v1_6 {
@@ -43,15 +61,192 @@ namespace client {
 class Connection : public esl::com::http::client::Connection {
 friend class Send;
 public:
-	Connection(CURL* curl, std::string hostUrl);
+	using Completion = AsyncSend::Completion;
+
+	struct BatchRequest {
+		BatchRequest(const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput);
+
+		const esl::com::http::client::Request& request;
+		esl::io::Output output;
+		std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput;
+	};
+
+	/* Contains either a response or the exception of the corresponding request */
+	struct BatchResult {
+		std::unique_ptr<esl::com::http::client::Response> response;
+		std::exception_ptr exceptionPtr;
+		Timing timing;
+	};
+
+	/* If 'multiplex' is set, send(...) hands the transfer to the event loop and waits for
+	 * its completion, so concurrent sends share HTTP/2 connections as separate streams.
+	 * If 'shared' is set, the connection may be used by several threads at the same time.
+	 * Each calling thread gets its own pooled handle, that is cached thread locally
+	 * until the connection is destroyed or the thread exits. Cookies are kept per thread. */
+	Connection(std::shared_ptr<HandlePool> handlePool, std::shared_ptr<MultiEngine> multiEngine, std::string hostUrl, bool multiplex, bool shared = false);
 	~Connection();
 
 	esl::com::http::client::Response send(const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const override;
 	esl::com::http::client::Response send(const esl::com::http::client::Request& request, esl::io::Output output, esl::io::Input input) const override;
 
+	/* Sends a contiguous in-memory body that is handed to libcurl without copying it. */
+	esl::com::http::client::Response send(const esl::com::http::client::Request& request, const void* data, std::size_t size, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const;
+	esl::com::http::client::Response send(const esl::com::http::client::Request& request, const void* data, std::size_t size, esl::io::Input input) const;
+
+	/* Sends a file as body with its size known in advance. It can be sent again by a retry or a redirect. */
+	esl::com::http::client::Response send(const esl::com::http::client::Request& request, std::shared_ptr<const UploadFile> file, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const;
+	esl::com::http::client::Response send(const esl::com::http::client::Request& request, std::shared_ptr<const UploadFile> file, esl::io::Input input) const;
+
+	/* Returns timings of the last blocking send on this connection, or of the calling thread if it is shared.
+	 * Values are read from libcurl only if this method is called. */
+	Timing getTiming() const;
+
+	/* Builds URL, method and header list once, so the request can be sent repeatedly with the send methods below. */
+	PreparedRequest prepare(const esl::com::http::client::Request& request) const;
+	esl::com::http::client::Response send(const PreparedRequest& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers& headers = PreparedRequest::Headers()) const;
+	esl::com::http::client::Response send(const PreparedRequest& request, const void* data, std::size_t size, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers& headers = PreparedRequest::Headers()) const;
+	esl::com::http::client::Response send(const PreparedRequest& request, std::shared_ptr<const UploadFile> file, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers& headers = PreparedRequest::Headers()) const;
+
+	/* Sends the request on the event loop thread of the factory, using its own pooled handle.
+	 * A GET request without body is hedged if hedging is enabled.
+	 * 'createInput' and the reader of 'output' are called on the event loop thread.
+	 * If 'timing' is given, it gets filled before 'completion' is called. */
+	void sendAsync(const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, Completion completion, Timing* timing = nullptr) const;
+	std::future<esl::com::http::client::Response> sendAsync(const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput) const;
+
+	/* Sends the request on 'socketEngine', so it is driven by the external event loop of the caller.
+	 * Must be called on the event loop thread, 'createInput', the reader of 'output' and 'completion' are called on it. */
+	void sendAsync(SocketEngine& socketEngine, const esl::com::http::client::Request& request, esl::io::Output output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, Completion completion, Timing* timing = nullptr) const;
+
+	/* Sends all requests on the event loop thread with at most 'concurrency' transfers at the same time
+	 * and waits until all of them have finished. Results are in the same order as the requests.
+	 * If 'concurrency' is 0, setting 'batch-concurrency' is used. */
+	std::vector<BatchResult> sendBatch(std::vector<BatchRequest> requests, std::size_t concurrency = 0) const;
+
+	/* Downloads the resource into file 'path' with up to 'segments' range requests at the same time.
+	 * Falls back to a single transfer if the server does not support ranges.
+	 * If 'segments' is 0, setting 'download-segments' is used. */
+	SegmentedDownload::Result download(const esl::com::http::client::Request& request, const std::string& path, std::size_t segments = 0) const;
+
 private:
-	CURL* curl;
+	/* state of blocking sends, a shared connection has one per thread */
+	struct ThreadState {
+		HandlePool::HandlePtr handle;
+
+		/* timing of the last blocking send performed by the event loop, as its handle is not kept */
+		Timing engineTiming;
+		bool lastSendOnEngine = false;
+
+		/* reused by blocking sends of a request that has not been prepared, so its memory is kept */
+		PreparedRequest request;
+		bool requestInUse = false;
+	};
+
+	/* Prepares a request for a blocking send in the memory of the thread state.
+	 * If a send within a callback of another send of the same thread uses it already, the request gets memory of its own. */
+	class RequestScope {
+	public:
+		RequestScope(const Connection& connection, const esl::com::http::client::Request& request);
+		RequestScope(const RequestScope&) = delete;
+		~RequestScope();
+
+		RequestScope& operator=(const RequestScope&) = delete;
+
+		const PreparedRequest& get() const noexcept;
+
+	private:
+		ThreadState& threadState;
+		std::unique_ptr<PreparedRequest> ownRequest;
+	};
+
+	/* States of all threads that have used a shared connection. A state is released
+	 * when its thread exits or when the connection is destroyed, whatever comes first. */
+	struct ThreadStates {
+		std::mutex mutex;
+		std::unordered_map<const ThreadState*, std::unique_ptr<ThreadState>> states;
+	};
+
+	/* thread local reference to the state of the thread in a shared connection */
+	struct ThreadEntry {
+		ThreadEntry() = default;
+		ThreadEntry(const ThreadEntry&) = delete;
+		/* releases the state if the connection has not been destroyed */
+		~ThreadEntry();
+
+		ThreadEntry& operator=(const ThreadEntry&) = delete;
+
+		/* expires if the connection has been destroyed */
+		std::weak_ptr<ThreadStates> owner;
+		/* owned by 'owner' */
+		ThreadState* state = nullptr;
+	};
+
+	/* State of sendBatch that is shared with the completions of its transfers,
+	 * so a completion that is still running when sendBatch returns does not refer to destroyed locals. */
+	class Batch : public std::enable_shared_from_this<Batch> {
+	public:
+		Batch(std::vector<BatchRequest> requests, std::shared_ptr<HandlePool> handlePool, std::shared_ptr<MultiEngine> multiEngine, const std::string& hostUrl);
+
+		/* Queues the next request to the event loop. Requests that cannot be queued are completed with their exception.
+		 * Returns false if there has been no request left. */
+		bool startNext();
+
+		/* waits until all requests have been completed */
+		std::vector<BatchResult> wait();
+
+	private:
+		void done(std::size_t index, const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr);
+		/* returns true if it has been the last request */
+		bool complete();
+
+		std::vector<BatchRequest> requests;
+		std::vector<BatchResult> results;
+
+		std::shared_ptr<HandlePool> handlePool;
+		std::shared_ptr<MultiEngine> multiEngine;
+		std::string hostUrl;
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::size_t nextIndex = 0;
+		std::size_t completed = 0;
+	};
+
+	/* returns the state of the calling thread, it does not lock if it exists already */
+	ThreadState& getThreadState() const;
+
+	esl::com::http::client::Response execute(const PreparedRequest& request, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers) const;
+	esl::com::http::client::Response execute(const PreparedRequest& request, Body body, esl::io::Input input) const;
+
+	/* serves the request from the response cache, revalidates a stale entry or stores a new response */
+	esl::com::http::client::Response executeCached(const PreparedRequest& request, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers) const;
+	esl::com::http::client::Response executeUncached(const PreparedRequest& request, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers) const;
+	esl::com::http::client::Response executeUncached(const PreparedRequest& request, Body body, esl::io::Input input) const;
+
+	/* returns true if the response of the request may be served from the response cache */
+	bool isCached(const PreparedRequest& request, const Body& body, const PreparedRequest::Headers* headers) const;
+
+	/* returns true if the request is sent as Hedge */
+	bool isHedged(const PreparedRequest& request, const Body& body) const;
+
+	static std::future<esl::com::http::client::Response> createFuture(Completion& completion);
+
+	std::shared_ptr<HandlePool> handlePool;
+	std::shared_ptr<MultiEngine> multiEngine;
 	std::string hostUrl;
+	bool multiplex;
+	bool shared;
+
+	/* key of the thread local entries, ids are never reused */
+	std::uint64_t id;
+	/* nullptr if the connection is not shared */
+	std::shared_ptr<ThreadStates> threadStates;
+
+	/* state of a connection that is not shared */
+	mutable ThreadState ownState;
+
+	static std::atomic<std::uint64_t> lastId;
+	static thread_local std::unordered_map<std::uint64_t, ThreadEntry> threadEntries;
 };
 
 } /* namespace client */
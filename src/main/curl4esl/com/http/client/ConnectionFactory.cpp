@@ -24,10 +24,6 @@ SOFTWARE.
 #include <curl4esl/com/http/client/Connection.h>
 
 #include <esl/Logger.h>
-#include <esl/system/Stacktrace.h>
-#include <esl/utility/URL.h>
-
-#include <stdexcept>
 
 namespace curl4esl {
 inline namespace v1_6 {
@@ -37,91 +33,40 @@ namespace client {
 
 namespace {
 esl::Logger logger("curl4esl::com::http::client::ConnectionFactory");
-
-struct CurlSingleton {
-	CurlSingleton() {
-        curl_global_init( CURL_GLOBAL_ALL );
-    }
-
-    ~CurlSingleton() {
-        curl_global_cleanup();
-    }
-
-    CURL* easyInit() {
-    	CURL* curlPtr = curl_easy_init();
-    	if(curlPtr == nullptr) {
-            throw esl::system::Stacktrace::add(std::runtime_error("curl init error"));
-    	}
-    	return curlPtr;
-    }
-};
-CurlSingleton curlSingleton;
-
-
-std::string createAuthenticationStr(const std::string& username, const std::string& password) {
-    if(!username.empty() && !password.empty()) {
-        return username+":"+password;
-    }
-    return username;
-}
-
 }
 
 ConnectionFactory::ConnectionFactory(const esl::com::http::client::CURLConnectionFactory::Settings& aSettings)
-: settings(aSettings)
+: settings(aSettings),
+  handlePool(new HandlePool(settings)),
+  multiEngine(new MultiEngine(settings.multiplex, settings.maxConcurrentStreams, settings.maxConnects))
 { }
 
 std::unique_ptr<esl::com::http::client::Connection> ConnectionFactory::createConnection() const {
-	CURL* curl = curlSingleton.easyInit();
-
-	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-	curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
-    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(curl, CURLOPT_AUTOREFERER, 0L);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 0L);
-    //curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
-    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");
-
-    // dont want to get a sig alarm on timeoutInSec
-    // (nur wen Timeout gesetzt wird ?)
-    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-
-	if(settings.timeout > 0) {
-		curl_easy_setopt(curl, CURLOPT_TIMEOUT, settings.timeout);
-	}
-
-	if(settings.hasLowSpeedDefinition) {
-        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, settings.lowSpeedLimit);
-        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, settings.lowSpeedTime);
-	}
+	return std::unique_ptr<esl::com::http::client::Connection>(createNativeConnection());
+}
 
-    /** set basic authentication if present*/
-	if(!settings.username.empty() || !settings.password.empty()) {
-		std::string basicAuthentication = createAuthenticationStr(settings.username, settings.password);
-        curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
-        curl_easy_setopt(curl, CURLOPT_USERPWD, basicAuthentication.c_str());
-	}
+std::unique_ptr<Connection> ConnectionFactory::createNativeConnection() const {
+	return std::unique_ptr<Connection>(new Connection(handlePool, multiEngine, settings.url, settings.multiplex, settings.sharedConnection));
+}
 
-	if(!settings.proxyServer.empty()) {
-		curl_easy_setopt(curl, CURLOPT_PROXY, settings.proxyServer.c_str());
-	}
+HandlePool::Statistics ConnectionFactory::getHandlePoolStatistics() const {
+	return handlePool->getStatistics();
+}
 
-	if(!settings.proxyUsername.empty() || !settings.proxyPassword.empty()) {
-		std::string proxyAuthentication = createAuthenticationStr(settings.proxyUsername, settings.proxyPassword);
-    	curl_easy_setopt(curl, CURLOPT_PROXYUSERPWD, proxyAuthentication.c_str());
-	}
+std::unique_ptr<SocketEngine> ConnectionFactory::createSocketEngine(SocketEngine::SocketHandler socketHandler, SocketEngine::TimerHandler timerHandler) const {
+	return std::unique_ptr<SocketEngine>(new SocketEngine(settings.multiplex, settings.maxConcurrentStreams, settings.maxConnects, std::move(socketHandler), std::move(timerHandler)));
+}
 
-    /** set user agent */
-	if(!settings.userAgent.empty()) {
-	    curl_easy_setopt(curl, CURLOPT_USERAGENT, settings.userAgent.c_str());
-	}
+Metrics::Snapshot ConnectionFactory::getMetrics() const {
+	Metrics::Snapshot snapshot;
 
-	/* ignore SSL certificate */
-	if(settings.skipSSLVerification) {
-		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+	Metrics* metrics = handlePool->getMetrics();
+	if(metrics) {
+		snapshot = metrics->getSnapshot();
 	}
+	snapshot.idleHandles = handlePool->getStatistics().idle;
 
-	return std::unique_ptr<esl::com::http::client::Connection>(new Connection(curl, settings.url));
+	return snapshot;
 }
 
 } /* namespace client */
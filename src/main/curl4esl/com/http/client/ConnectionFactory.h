@@ -27,7 +27,10 @@ SOFTWARE.
 #include <esl/com/http/client/ConnectionFactory.h>
 #include <esl/com/http/client/CURLConnectionFactory.h>
 
-#include <curl/curl.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/Metrics.h>
+#include <curl4esl/com/http/client/MultiEngine.h>
+#include <curl4esl/com/http/client/SocketEngine.h>
 
 #include <memory>
 
@@ -37,14 +40,30 @@ namespace com {
 namespace http {
 namespace client {
 
+class Connection;
+
 class ConnectionFactory : public esl::com::http::client::ConnectionFactory {
 public:
 	ConnectionFactory(const esl::com::http::client::CURLConnectionFactory::Settings& settings);
 
 	std::unique_ptr<esl::com::http::client::Connection> createConnection() const override;
 
+	/* Same as createConnection(), but gives access to sendAsync, sendBatch, prepare, download, getTiming, ... */
+	std::unique_ptr<Connection> createNativeConnection() const;
+
+	HandlePool::Statistics getHandlePoolStatistics() const;
+
+	/* snapshot of all counters, histograms are empty if metrics are disabled */
+	Metrics::Snapshot getMetrics() const;
+
+	/* Creates an engine for an external event loop, configured like the event loop of this factory.
+	 * Requests are sent on it by Connection::sendAsync(SocketEngine&, ...). */
+	std::unique_ptr<SocketEngine> createSocketEngine(SocketEngine::SocketHandler socketHandler, SocketEngine::TimerHandler timerHandler) const;
+
 private:
 	esl::com::http::client::CURLConnectionFactory::Settings settings;
+	std::shared_ptr<HandlePool> handlePool;
+	std::shared_ptr<MultiEngine> multiEngine;
 };
 
 } /* namespace client */
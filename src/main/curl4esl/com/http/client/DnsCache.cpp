@@ -0,0 +1,207 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/DnsCache.h>
+
+#include <esl/Logger.h>
+#include <esl/utility/URL.h>
+
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+esl::Logger logger("curl4esl::com::http::client::DnsCache");
+
+/* a failed refresh is repeated earlier than a successful one */
+constexpr std::chrono::seconds retryInterval(1);
+
+std::string resolveByGetaddrinfo(const std::string& host, const std::string& port, esl::com::http::client::CURLConnectionFactory::Settings::IpVersion ipVersion) {
+#ifdef _WIN32
+	return "";
+#else
+	addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	/* otherwise each address is returned once per socket type */
+	hints.ai_socktype = SOCK_STREAM;
+	switch(ipVersion) {
+	case esl::com::http::client::CURLConnectionFactory::Settings::IpVersion::ipv4:
+		hints.ai_family = AF_INET;
+		break;
+	case esl::com::http::client::CURLConnectionFactory::Settings::IpVersion::ipv6:
+		hints.ai_family = AF_INET6;
+		break;
+	default:
+		hints.ai_family = AF_UNSPEC;
+		break;
+	}
+
+	addrinfo* result = nullptr;
+	int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+	if(rc != 0) {
+		logger.warn << "resolving \"" << host << "\" failed: " << gai_strerror(rc) << "\n";
+		return "";
+	}
+
+	std::string addresses;
+	for(addrinfo* info = result; info; info = info->ai_next) {
+		char buffer[INET6_ADDRSTRLEN];
+		const char* address = nullptr;
+		if(info->ai_family == AF_INET) {
+			address = inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in*>(info->ai_addr)->sin_addr, buffer, sizeof(buffer));
+		}
+		else if(info->ai_family == AF_INET6) {
+			address = inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6*>(info->ai_addr)->sin6_addr, buffer, sizeof(buffer));
+		}
+		if(address == nullptr) {
+			continue;
+		}
+
+		if(!addresses.empty()) {
+			addresses += ",";
+		}
+		if(info->ai_family == AF_INET6) {
+			addresses += "[" + std::string(address) + "]";
+		}
+		else {
+			addresses += address;
+		}
+	}
+	freeaddrinfo(result);
+
+	return addresses;
+#endif
+}
+}  // anonymer namespace
+
+DnsCache::ResolveList::ResolveList(curl_slist* aList)
+: list(aList)
+{ }
+
+DnsCache::ResolveList::~ResolveList() {
+	curl_slist_free_all(list);
+}
+
+curl_slist* DnsCache::ResolveList::get() const noexcept {
+	return list;
+}
+
+DnsCache::DnsCache(const esl::com::http::client::CURLConnectionFactory::Settings& aSettings, Resolver aResolver)
+: settings(aSettings),
+  resolver(aResolver ? std::move(aResolver) : Resolver(resolveByGetaddrinfo))
+{
+#ifndef _WIN32
+	/* with a proxy libcurl resolves the proxy, not the host */
+	if(settings.dnsRefresh <= 0 || settings.url.empty() || !settings.proxyServer.empty()) {
+		return;
+	}
+
+	esl::utility::URL url(settings.url);
+	host = url.getHostname();
+	port = url.getPort();
+	if(port.empty()) {
+		port = url.getScheme() == esl::utility::Protocol::Type::https ? "443" : "80";
+	}
+
+	/* IP literals need no resolution */
+	if(host.empty() || host.front() == '[') {
+		return;
+	}
+	unsigned char address[sizeof(in6_addr)];
+	if(inet_pton(AF_INET, host.c_str(), address) == 1 || inet_pton(AF_INET6, host.c_str(), address) == 1) {
+		return;
+	}
+
+	thread = std::thread(&DnsCache::run, this);
+#endif
+}
+
+DnsCache::~DnsCache() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopped = true;
+	}
+	condition.notify_all();
+
+	if(thread.joinable()) {
+		thread.join();
+	}
+}
+
+bool DnsCache::isEnabled() const noexcept {
+	return thread.joinable();
+}
+
+std::shared_ptr<const DnsCache::ResolveList> DnsCache::getResolveList() const {
+	return std::atomic_load(&resolveList);
+}
+
+void DnsCache::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while(!stopped) {
+		lock.unlock();
+		std::shared_ptr<const ResolveList> list = resolve();
+		if(list) {
+			std::atomic_store(&resolveList, list);
+		}
+		lock.lock();
+
+		condition.wait_for(lock, list ? std::chrono::seconds(settings.dnsRefresh) : retryInterval, [this] {
+			return stopped;
+		});
+	}
+}
+
+std::shared_ptr<const DnsCache::ResolveList> DnsCache::resolve() const {
+	std::string addresses = resolver(host, port, settings.ipVersion);
+	if(addresses.empty()) {
+		return nullptr;
+	}
+
+	/* "host:port:address[,address]..." */
+	std::string entry = host + ":" + port + ":" + addresses;
+	curl_slist* list = curl_slist_append(nullptr, entry.c_str());
+	if(list == nullptr) {
+		return nullptr;
+	}
+	return std::make_shared<const ResolveList>(list);
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
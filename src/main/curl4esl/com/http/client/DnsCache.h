@@ -0,0 +1,106 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_DNSCACHE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_DNSCACHE_H_
+
+#include <esl/com/http/client/CURLConnectionFactory.h>
+
+#include <curl/curl.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Resolves the host of setting 'url' on a thread of its own every 'dnsRefresh' seconds.
+ * Sends pass the latest addresses to libcurl by CURLOPT_RESOLVE, so they never wait for
+ * the resolver. getaddrinfo does not report the TTL of a record, so the refresh interval
+ * is configured instead. If a refresh fails, the previous addresses are kept. */
+class DnsCache {
+public:
+	/* CURLOPT_RESOLVE list of a single resolution, it is freed when the last send using it is done */
+	class ResolveList {
+	public:
+		ResolveList(curl_slist* list);
+		ResolveList(const ResolveList&) = delete;
+		~ResolveList();
+
+		ResolveList& operator=(const ResolveList&) = delete;
+
+		curl_slist* get() const noexcept;
+
+	private:
+		curl_slist* list;
+	};
+
+	/* Returns the addresses of 'host' as "address[,address]...", IPv6 addresses in brackets,
+	 * or an empty string if resolving failed. The default resolver calls getaddrinfo. */
+	using Resolver = std::function<std::string(const std::string& host, const std::string& port, esl::com::http::client::CURLConnectionFactory::Settings::IpVersion ipVersion)>;
+
+	DnsCache(const esl::com::http::client::CURLConnectionFactory::Settings& settings, Resolver resolver = Resolver());
+	DnsCache(const DnsCache&) = delete;
+	~DnsCache();
+
+	DnsCache& operator=(const DnsCache&) = delete;
+
+	bool isEnabled() const noexcept;
+
+	/* returns nullptr if the host has not been resolved yet */
+	std::shared_ptr<const ResolveList> getResolveList() const;
+
+private:
+	void run();
+
+	/* returns nullptr if resolving failed */
+	std::shared_ptr<const ResolveList> resolve() const;
+
+	const esl::com::http::client::CURLConnectionFactory::Settings& settings;
+	Resolver resolver;
+	std::string host;
+	std::string port;
+
+	/* accessed by std::atomic_load and std::atomic_store */
+	std::shared_ptr<const ResolveList> resolveList;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopped = false;
+	std::thread thread;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_DNSCACHE_H_ */
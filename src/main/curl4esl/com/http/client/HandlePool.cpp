@@ -0,0 +1,372 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/Send.h>
+
+#include <esl/Logger.h>
+#include <esl/system/Stacktrace.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+esl::Logger logger("curl4esl::com::http::client::HandlePool");
+
+/* larger receive buffers are not kept in idle handles */
+constexpr std::size_t maxIdleReceiveBufferCapacity = 1024 * 1024;
+
+struct CurlSingleton {
+	CurlSingleton() {
+        curl_global_init( CURL_GLOBAL_ALL );
+    }
+
+    ~CurlSingleton() {
+        curl_global_cleanup();
+    }
+
+    CURL* easyInit() {
+    	CURL* curlPtr = curl_easy_init();
+    	if(curlPtr == nullptr) {
+            throw esl::system::Stacktrace::add(std::runtime_error("curl init error"));
+    	}
+    	return curlPtr;
+    }
+};
+CurlSingleton curlSingleton;
+
+
+std::string createAuthenticationStr(const std::string& username, const std::string& password) {
+    if(!username.empty() && !password.empty()) {
+        return username+":"+password;
+    }
+    return username;
+}
+
+}
+
+void HandlePool::Release::operator()(Handle* handle) const {
+	if(pool) {
+		pool->release(handle);
+	}
+	else if(handle) {
+		curl_easy_cleanup(handle->curl);
+		delete handle;
+	}
+}
+
+HandlePool::HandlePool(const esl::com::http::client::CURLConnectionFactory::Settings& aSettings, DnsCache::Resolver resolver)
+: settings(aSettings),
+  share(settings.shareConnectionCache),
+  retryPolicy(settings),
+  hedgePolicy(settings),
+  responseCache(settings),
+  dnsCache(settings, std::move(resolver))
+{ }
+
+HandlePool::~HandlePool() {
+	destroy(idleHandles);
+}
+
+HandlePool::HandlePtr HandlePool::acquire() {
+	Handle* handle = nullptr;
+	std::vector<Handle*> expired;
+	auto now = std::chrono::steady_clock::now();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		evict(now, expired);
+		if(!idleHandles.empty()) {
+			handle = idleHandles.back();
+			idleHandles.pop_back();
+		}
+	}
+	destroy(expired);
+
+	if(handle) {
+		++hits;
+	}
+	else {
+		++misses;
+		handle = createHandle();
+	}
+	handle->lastUsed = now;
+
+	if(settings.metrics) {
+		metrics.handleAcquired();
+	}
+
+	return HandlePtr(handle, Release{shared_from_this()});
+}
+
+const esl::com::http::client::CURLConnectionFactory::Settings& HandlePool::getSettings() const noexcept {
+	return settings;
+}
+
+HandlePool::Statistics HandlePool::getStatistics() const {
+	Statistics statistics;
+
+	statistics.hits = hits.load();
+	statistics.misses = misses.load();
+	statistics.evictions = evictions.load();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		statistics.idle = idleHandles.size();
+	}
+
+	return statistics;
+}
+
+Metrics* HandlePool::getMetrics() noexcept {
+	return settings.metrics ? &metrics : nullptr;
+}
+
+RetryPolicy& HandlePool::getRetryPolicy() noexcept {
+	return retryPolicy;
+}
+
+HedgePolicy& HandlePool::getHedgePolicy() noexcept {
+	return hedgePolicy;
+}
+
+ResponseCache& HandlePool::getResponseCache() noexcept {
+	return responseCache;
+}
+
+const DnsCache& HandlePool::getDnsCache() const noexcept {
+	return dnsCache;
+}
+
+HandlePool::Handle* HandlePool::createHandle() {
+	CURL* curl = curlSingleton.easyInit();
+
+	curl_easy_setopt(curl, CURLOPT_SHARE, share.get());
+	Send::initHandle(curl);
+
+	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_AUTOREFERER, 0L);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 0L);
+    //curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
+    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");
+
+    // dont want to get a sig alarm on timeoutInSec
+    // (nur wen Timeout gesetzt wird ?)
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+	if(settings.timeoutMs > 0) {
+		curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, settings.timeoutMs);
+	}
+	else if(settings.timeout > 0) {
+		curl_easy_setopt(curl, CURLOPT_TIMEOUT, settings.timeout);
+	}
+
+	if(settings.connectTimeoutMs > 0) {
+		curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, settings.connectTimeoutMs);
+	}
+	if(settings.expect100TimeoutMs > 0) {
+		curl_easy_setopt(curl, CURLOPT_EXPECT_100_TIMEOUT_MS, settings.expect100TimeoutMs);
+	}
+
+	if(settings.bufferSize > 0) {
+		curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, settings.bufferSize);
+	}
+	if(settings.uploadBufferSize > 0) {
+		curl_easy_setopt(curl, CURLOPT_UPLOAD_BUFFERSIZE, settings.uploadBufferSize);
+	}
+
+	curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, settings.tcpNoDelay ? 1L : 0L);
+	if(settings.tcpKeepAliveIdle > 0) {
+		curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, settings.tcpKeepAliveIdle);
+	}
+	if(settings.tcpKeepAliveInterval > 0) {
+		curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, settings.tcpKeepAliveInterval);
+	}
+
+	if(settings.maxConnects > 0) {
+		curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, settings.maxConnects);
+	}
+
+	switch(settings.ipVersion) {
+	case esl::com::http::client::CURLConnectionFactory::Settings::IpVersion::ipv4:
+		curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+		break;
+	case esl::com::http::client::CURLConnectionFactory::Settings::IpVersion::ipv6:
+		curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V6);
+		break;
+	default:
+		break;
+	}
+
+	if(settings.hasLowSpeedDefinition) {
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, settings.lowSpeedLimit);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, settings.lowSpeedTime);
+	}
+
+    /** set basic authentication if present*/
+	if(!settings.username.empty() || !settings.password.empty()) {
+		std::string basicAuthentication = createAuthenticationStr(settings.username, settings.password);
+        curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
+        curl_easy_setopt(curl, CURLOPT_USERPWD, basicAuthentication.c_str());
+	}
+
+	if(!settings.proxyServer.empty()) {
+		curl_easy_setopt(curl, CURLOPT_PROXY, settings.proxyServer.c_str());
+	}
+
+	if(!settings.proxyUsername.empty() || !settings.proxyPassword.empty()) {
+		std::string proxyAuthentication = createAuthenticationStr(settings.proxyUsername, settings.proxyPassword);
+    	curl_easy_setopt(curl, CURLOPT_PROXYUSERPWD, proxyAuthentication.c_str());
+	}
+
+    /** set user agent */
+	if(!settings.userAgent.empty()) {
+	    curl_easy_setopt(curl, CURLOPT_USERAGENT, settings.userAgent.c_str());
+	}
+
+	switch(settings.httpVersion) {
+	case esl::com::http::client::CURLConnectionFactory::Settings::HttpVersion::http1_1:
+		curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_1_1));
+		break;
+	case esl::com::http::client::CURLConnectionFactory::Settings::HttpVersion::http2:
+		curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+		break;
+	case esl::com::http::client::CURLConnectionFactory::Settings::HttpVersion::http2PriorKnowledge:
+		curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE));
+		break;
+	default:
+		break;
+	}
+
+	/* wait for a connection that can be multiplexed instead of opening a new one */
+	if(settings.multiplex) {
+		curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+	}
+
+	/* let libcurl decode compressed bodies before they are passed to the write callback,
+	 * an empty string advertises all codings libcurl has been built with */
+	if(settings.hasAcceptEncoding) {
+		curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, settings.acceptEncoding.c_str());
+	}
+
+	/* ignore SSL certificate */
+	if(settings.skipSSLVerification) {
+		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+	}
+
+	Handle* handle = new Handle;
+	handle->pool = this;
+	handle->curl = curl;
+	handle->created = std::chrono::steady_clock::now();
+	handle->lastUsed = handle->created;
+	handle->uploadBufferSize = settings.uploadBufferSize > 0 ? settings.uploadBufferSize : 0;
+	return handle;
+}
+
+void HandlePool::release(Handle* handle) {
+	if(handle == nullptr) {
+		return;
+	}
+
+	if(settings.metrics) {
+		metrics.handleReleased();
+	}
+
+	/* cookies must not leak from one Connection to the next one */
+	curl_easy_setopt(handle->curl, CURLOPT_COOKIELIST, "ALL");
+
+	handle->receiveBuffer.clear();
+	handle->receiveBuffer.shrink(maxIdleReceiveBufferCapacity);
+
+	std::size_t pipelineCapacity = 0;
+	for(const auto& buffer : handle->pipelineBuffers) {
+		pipelineCapacity += buffer.capacity();
+	}
+	if(pipelineCapacity > maxIdleReceiveBufferCapacity) {
+		std::vector<std::vector<std::uint8_t>>().swap(handle->pipelineBuffers);
+	}
+
+	std::vector<Handle*> expired;
+	auto now = std::chrono::steady_clock::now();
+	handle->lastUsed = now;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(isExpired(*handle, now) || idleHandles.size() >= settings.poolMaxIdle) {
+			expired.push_back(handle);
+			++evictions;
+		}
+		else {
+			idleHandles.push_back(handle);
+		}
+		evict(now, expired);
+	}
+
+	destroy(expired);
+}
+
+void HandlePool::evict(std::chrono::steady_clock::time_point now, std::vector<Handle*>& expired) {
+	std::size_t count = 0;
+	for(auto handle : idleHandles) {
+		if(isExpired(*handle, now)) {
+			expired.push_back(handle);
+			++evictions;
+		}
+		else {
+			idleHandles[count] = handle;
+			++count;
+		}
+	}
+	idleHandles.resize(count);
+}
+
+bool HandlePool::isExpired(const Handle& handle, std::chrono::steady_clock::time_point now) const {
+	if(settings.poolMaxLifetime > 0 && now - handle.created >= std::chrono::seconds(settings.poolMaxLifetime)) {
+		return true;
+	}
+	if(settings.poolIdleTimeout > 0 && now - handle.lastUsed >= std::chrono::seconds(settings.poolIdleTimeout)) {
+		return true;
+	}
+	return false;
+}
+
+void HandlePool::destroy(std::vector<Handle*>& handles) {
+	for(auto handle : handles) {
+		curl_easy_cleanup(handle->curl);
+		delete handle;
+	}
+	handles.clear();
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
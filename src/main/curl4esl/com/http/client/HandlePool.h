@@ -0,0 +1,147 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_HANDLEPOOL_H_
+#define CURL4ESL_COM_HTTP_CLIENT_HANDLEPOOL_H_
+
+#include <esl/com/http/client/CURLConnectionFactory.h>
+
+#include <curl4esl/com/http/client/DnsCache.h>
+#include <curl4esl/com/http/client/HeaderList.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+#include <curl4esl/com/http/client/HedgePolicy.h>
+#include <curl4esl/com/http/client/Metrics.h>
+#include <curl4esl/com/http/client/ReceiveBuffer.h>
+#include <curl4esl/com/http/client/ResponseCache.h>
+#include <curl4esl/com/http/client/RetryPolicy.h>
+#include <curl4esl/com/http/client/Share.h>
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Bounded pool of pre-configured CURL easy handles. A handle keeps its
+ * connection cache, so returning it to the pool instead of cleaning it up
+ * allows the next Connection to reuse an established TCP/TLS connection. */
+class HandlePool : public std::enable_shared_from_this<HandlePool> {
+public:
+	struct Handle {
+		/* pool this handle belongs to, it outlives the handle */
+		HandlePool* pool = nullptr;
+		CURL* curl = nullptr;
+		std::chrono::steady_clock::time_point created;
+		std::chrono::steady_clock::time_point lastUsed;
+
+		/* value of CURLOPT_UPLOAD_BUFFERSIZE, 0 for the default of libcurl.
+		 * Setting it frees the buffer, so it is only set if a send needs another size. */
+		long uploadBufferSize = 0;
+
+		/* reused by all transfers on this handle */
+		HeaderList requestHeaders;
+		HeaderStore responseHeaders;
+		ReceiveBuffer receiveBuffer;
+		std::vector<std::vector<std::uint8_t>> pipelineBuffers;
+	};
+
+	struct Release {
+		std::shared_ptr<HandlePool> pool;
+		void operator()(Handle* handle) const;
+	};
+	using HandlePtr = std::unique_ptr<Handle, Release>;
+
+	struct Statistics {
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		/* handles destroyed because they have expired or the pool has been full when they have been released */
+		std::uint64_t evictions = 0;
+		std::size_t idle = 0;
+	};
+
+	/* 'resolver' replaces getaddrinfo for the DNS cache, e.g. by tests */
+	HandlePool(const esl::com::http::client::CURLConnectionFactory::Settings& settings, DnsCache::Resolver resolver = DnsCache::Resolver());
+	~HandlePool();
+
+	HandlePtr acquire();
+
+	const esl::com::http::client::CURLConnectionFactory::Settings& getSettings() const noexcept;
+
+	Statistics getStatistics() const;
+
+	/* returns nullptr if metrics are disabled */
+	Metrics* getMetrics() noexcept;
+
+	RetryPolicy& getRetryPolicy() noexcept;
+
+	HedgePolicy& getHedgePolicy() noexcept;
+
+	ResponseCache& getResponseCache() noexcept;
+
+	const DnsCache& getDnsCache() const noexcept;
+
+private:
+	Handle* createHandle();
+	void release(Handle* handle);
+
+	/* moves expired handles from idleHandles to 'expired', mutex must be locked */
+	void evict(std::chrono::steady_clock::time_point now, std::vector<Handle*>& expired);
+	bool isExpired(const Handle& handle, std::chrono::steady_clock::time_point now) const;
+
+	static void destroy(std::vector<Handle*>& handles);
+
+	const esl::com::http::client::CURLConnectionFactory::Settings settings;
+
+	/* must be declared before the handles, so it is destroyed after them */
+	Share share;
+
+	mutable std::mutex mutex;
+	/* idle handles, most recently used at the end */
+	std::vector<Handle*> idleHandles;
+
+	std::atomic<std::uint64_t> hits { 0 };
+	std::atomic<std::uint64_t> misses { 0 };
+	std::atomic<std::uint64_t> evictions { 0 };
+
+	Metrics metrics;
+	RetryPolicy retryPolicy;
+	HedgePolicy hedgePolicy;
+	ResponseCache responseCache;
+	DnsCache dnsCache;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_HANDLEPOOL_H_ */
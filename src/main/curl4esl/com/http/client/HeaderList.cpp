@@ -0,0 +1,141 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/HeaderList.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* enough for the headers of a typical request */
+constexpr std::size_t minBlockSize = 2048;
+}  // anonymer namespace
+
+HeaderList::HeaderList(HeaderList&& other) noexcept
+: blocks(std::move(other.blocks)),
+  currentBlock(other.currentBlock),
+  currentUsed(other.currentUsed),
+  head(other.head),
+  tail(other.tail)
+{
+	other.blocks.clear();
+	other.clear();
+}
+
+HeaderList& HeaderList::operator=(HeaderList&& other) noexcept {
+	if(this != &other) {
+		/* nodes are placed in the blocks, so their addresses stay valid */
+		blocks = std::move(other.blocks);
+		currentBlock = other.currentBlock;
+		currentUsed = other.currentUsed;
+		head = other.head;
+		tail = other.tail;
+
+		other.blocks.clear();
+		other.clear();
+	}
+	return *this;
+}
+
+void HeaderList::add(const std::string& key, const std::string& value) {
+	/* "key: value\0" or "key;\0" */
+	std::size_t length = key.size() + (value.empty() ? 1 : 2 + value.size());
+
+	char* memory = allocate(sizeof(curl_slist) + length + 1);
+	curl_slist* node = reinterpret_cast<curl_slist*>(memory);
+	char* data = memory + sizeof(curl_slist);
+
+	std::memcpy(data, key.data(), key.size());
+	if(value.empty()) {
+		data[key.size()] = ';';
+	}
+	else {
+		data[key.size()] = ':';
+		data[key.size() + 1] = ' ';
+		std::memcpy(data + key.size() + 2, value.data(), value.size());
+	}
+	data[length] = '\0';
+
+	node->data = data;
+	node->next = nullptr;
+	if(tail) {
+		tail->next = node;
+	}
+	else {
+		head = node;
+	}
+	tail = node;
+}
+
+void HeaderList::clear() noexcept {
+	currentBlock = 0;
+	currentUsed = 0;
+	head = nullptr;
+	tail = nullptr;
+}
+
+curl_slist* HeaderList::getHead() const noexcept {
+	return head;
+}
+
+curl_slist* HeaderList::getTail() const noexcept {
+	return tail;
+}
+
+char* HeaderList::allocate(std::size_t size) {
+	/* nodes start aligned, as they are followed by their string */
+	constexpr std::size_t alignment = alignof(curl_slist);
+	size = (size + alignment - 1) & ~(alignment - 1);
+
+	while(currentBlock < blocks.size()) {
+		Block& block = blocks[currentBlock];
+		if(block.size - currentUsed >= size) {
+			char* memory = block.data.get() + currentUsed;
+			currentUsed += size;
+			return memory;
+		}
+		++currentBlock;
+		currentUsed = 0;
+	}
+
+	Block block;
+	block.size = std::max(minBlockSize, size);
+	block.data.reset(new char[block.size]);
+	blocks.push_back(std::move(block));
+
+	currentBlock = blocks.size() - 1;
+	currentUsed = size;
+	return blocks.back().data.get();
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
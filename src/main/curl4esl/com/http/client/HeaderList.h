@@ -0,0 +1,85 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_HEADERLIST_H_
+#define CURL4ESL_COM_HTTP_CLIENT_HEADERLIST_H_
+
+#include <curl/curl.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Header list for CURLOPT_HTTPHEADER. Unlike curl_slist_append, which allocates every
+ * node and string on its own, nodes and strings are placed in blocks of this list.
+ * libcurl only reads the list, so it must not be freed by curl_slist_free_all.
+ * Blocks are kept by clear(), so a reused list does not allocate in steady state. */
+class HeaderList {
+public:
+	HeaderList() = default;
+	HeaderList(const HeaderList&) = delete;
+	HeaderList(HeaderList&& other) noexcept;
+
+	HeaderList& operator=(const HeaderList&) = delete;
+	HeaderList& operator=(HeaderList&& other) noexcept;
+
+	/* adds "key: value" or "key;" for an empty value */
+	void add(const std::string& key, const std::string& value);
+
+	/* removes all headers, but keeps the memory */
+	void clear() noexcept;
+
+	/* nullptr if the list is empty */
+	curl_slist* getHead() const noexcept;
+	curl_slist* getTail() const noexcept;
+
+private:
+	struct Block {
+		std::unique_ptr<char[]> data;
+		std::size_t size = 0;
+	};
+
+	char* allocate(std::size_t size);
+
+	std::vector<Block> blocks;
+	/* block that is allocated from and the bytes used of it */
+	std::size_t currentBlock = 0;
+	std::size_t currentUsed = 0;
+
+	curl_slist* head = nullptr;
+	curl_slist* tail = nullptr;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_HEADERLIST_H_ */
@@ -0,0 +1,223 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/HeaderStore.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+inline char toLower(char c) noexcept {
+	return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline bool isWhitespace(char c) noexcept {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void trim(const char*& begin, const char*& end) noexcept {
+	while(begin < end && isWhitespace(*begin)) {
+		++begin;
+	}
+	while(end > begin && isWhitespace(*(end - 1))) {
+		--end;
+	}
+}
+}  // anonymer namespace
+
+void HeaderStore::clear() noexcept {
+	count = 0;
+}
+
+bool HeaderStore::empty() const noexcept {
+	return count == 0;
+}
+
+std::size_t HeaderStore::size() const noexcept {
+	return count;
+}
+
+void HeaderStore::add(const char* key, std::size_t keyLength, const char* value, std::size_t valueLength) {
+	if(count == entries.size()) {
+		entries.emplace_back();
+	}
+
+	Entry& entry = entries[count];
+	entry.first.assign(key, keyLength);
+	entry.second.assign(value, valueLength);
+	++count;
+}
+
+void HeaderStore::appendToLast(const char* value, std::size_t valueLength) {
+	if(count == 0) {
+		return;
+	}
+
+	std::string& lastValue = entries[count - 1].second;
+	if(!lastValue.empty() && valueLength > 0) {
+		lastValue += ' ';
+	}
+	lastValue.append(value, valueLength);
+}
+
+void HeaderStore::addLine(const char* data, std::size_t size) {
+	const char* begin = data;
+	const char* end = data + size;
+
+	/* continuation line of obsolete line folding */
+	if(begin < end && (*begin == ' ' || *begin == '\t')) {
+		trim(begin, end);
+		appendToLast(begin, static_cast<std::size_t>(end - begin));
+		return;
+	}
+
+	trim(begin, end);
+
+	/* status line of a new response */
+	if(end - begin >= 5 && std::memcmp(begin, "HTTP/", 5) == 0) {
+		clear();
+		return;
+	}
+
+	const char* separator = static_cast<const char*>(std::memchr(begin, ':', static_cast<std::size_t>(end - begin)));
+	if(separator == nullptr) {
+		return;
+	}
+
+	const char* keyBegin = begin;
+	const char* keyEnd = separator;
+	trim(keyBegin, keyEnd);
+
+	const char* valueBegin = separator + 1;
+	const char* valueEnd = end;
+	trim(valueBegin, valueEnd);
+
+	if(keyBegin < keyEnd) {
+		add(keyBegin, static_cast<std::size_t>(keyEnd - keyBegin), valueBegin, static_cast<std::size_t>(valueEnd - valueBegin));
+	}
+}
+
+const HeaderStore::Entry& HeaderStore::operator[](std::size_t index) const noexcept {
+	return entries[index];
+}
+
+const std::string* HeaderStore::find(const char* key, std::size_t keyLength) const noexcept {
+	for(std::size_t i = 0; i < count; ++i) {
+		const Entry& entry = entries[i];
+		if(equalsIgnoreCase(entry.first.data(), entry.first.size(), key, keyLength)) {
+			return &entry.second;
+		}
+	}
+	return nullptr;
+}
+
+const std::string* HeaderStore::find(const std::string& key) const noexcept {
+	return find(key.data(), key.size());
+}
+
+void HeaderStore::remove(const char* key, std::size_t keyLength) noexcept {
+	std::size_t i = 0;
+	while(i < count) {
+		Entry& entry = entries[i];
+		if(equalsIgnoreCase(entry.first.data(), entry.first.size(), key, keyLength)) {
+			std::rotate(entries.begin() + i, entries.begin() + i + 1, entries.begin() + count);
+			--count;
+		}
+		else {
+			++i;
+		}
+	}
+}
+
+std::map<std::string, std::string> HeaderStore::toMap() const {
+	std::map<std::string, std::string> headers;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		const Entry& entry = entries[i];
+		auto result = headers.insert(entry);
+		if(result.second) {
+			continue;
+		}
+
+		if(equalsIgnoreCase(entry.first.data(), entry.first.size(), "Set-Cookie", 10)) {
+			result.first->second += '\n';
+			result.first->second += entry.second;
+		}
+		else {
+			result.first->second += ", ";
+			result.first->second += entry.second;
+		}
+	}
+
+	return headers;
+}
+
+std::vector<std::string> HeaderStore::splitSetCookie(const std::string& value) {
+	std::vector<std::string> values;
+
+	std::size_t begin = 0;
+	while(true) {
+		std::size_t end = value.find('\n', begin);
+		values.emplace_back(value, begin, end == std::string::npos ? std::string::npos : end - begin);
+		if(end == std::string::npos) {
+			break;
+		}
+		begin = end + 1;
+	}
+
+	return values;
+}
+
+const std::string* HeaderStore::find(const std::map<std::string, std::string>& headers, const char* key) {
+	std::size_t keyLength = std::char_traits<char>::length(key);
+
+	for(const auto& header : headers) {
+		if(equalsIgnoreCase(header.first.data(), header.first.size(), key, keyLength)) {
+			return &header.second;
+		}
+	}
+	return nullptr;
+}
+
+bool HeaderStore::equalsIgnoreCase(const char* str1, std::size_t length1, const char* str2, std::size_t length2) noexcept {
+	if(length1 != length2) {
+		return false;
+	}
+	for(std::size_t i = 0; i < length1; ++i) {
+		if(toLower(str1[i]) != toLower(str2[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,93 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_HEADERSTORE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_HEADERSTORE_H_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Flat store of response header fields in received order.
+ * Duplicate fields like Set-Cookie are kept as separate entries and
+ * lookup is case insensitive, as field names of HTTP/2 are lower case.
+ * Strings are reused when the store is cleared, so it is allocation
+ * free in steady state if it is reused for following transfers. */
+class HeaderStore {
+public:
+	using Entry = std::pair<std::string, std::string>;
+
+	void clear() noexcept;
+	bool empty() const noexcept;
+	std::size_t size() const noexcept;
+
+	void add(const char* key, std::size_t keyLength, const char* value, std::size_t valueLength);
+
+	/* appends a continuation line to the value of the last field */
+	void appendToLast(const char* value, std::size_t valueLength);
+
+	/* Parses a line as passed to CURLOPT_HEADERFUNCTION: a status line clears the store, e.g. after
+	 * "100 Continue", a continuation line is appended to the last field, lines without ':' are ignored. */
+	void addLine(const char* data, std::size_t size);
+
+	const Entry& operator[](std::size_t index) const noexcept;
+
+	/* returns the value of the first field with this name or nullptr */
+	const std::string* find(const char* key, std::size_t keyLength) const noexcept;
+	const std::string* find(const std::string& key) const noexcept;
+
+	/* removes all fields with this name, their strings are kept for reuse */
+	void remove(const char* key, std::size_t keyLength) noexcept;
+
+	/* Duplicate fields are combined into one value separated by ", " (RFC 9110, section 5.3).
+	 * Set-Cookie values may contain commas, so they are separated by "\n" instead, which cannot
+	 * be part of a field value. splitSetCookie returns them one by one. */
+	std::map<std::string, std::string> toMap() const;
+
+	/* splits the Set-Cookie value of a header map created by toMap() */
+	static std::vector<std::string> splitSetCookie(const std::string& value);
+
+	/* case insensitive lookup in the header map of a response, returns nullptr if not found */
+	static const std::string* find(const std::map<std::string, std::string>& headers, const char* key);
+
+	static bool equalsIgnoreCase(const char* str1, std::size_t length1, const char* str2, std::size_t length2) noexcept;
+
+private:
+	std::vector<Entry> entries;
+	std::size_t count = 0;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_HEADERSTORE_H_ */
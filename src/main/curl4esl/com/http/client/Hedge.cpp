@@ -0,0 +1,183 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/Hedge.h>
+#include <curl4esl/com/http/client/Body.h>
+#include <curl4esl/com/http/client/HedgePolicy.h>
+#include <curl4esl/com/http/client/Metrics.h>
+
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+void Hedge::start(std::shared_ptr<HandlePool> handlePool, const std::shared_ptr<MultiEngine>& multiEngine, std::shared_ptr<const PreparedRequest> request,
+		std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, AsyncSend::Completion completion, const PreparedRequest::Headers* headers, Timing* timing) {
+	HedgePolicy& hedgePolicy = handlePool->getHedgePolicy();
+	hedgePolicy.recordRequest();
+
+	/* an adaptive delay is not known until enough responses have been measured, the request is not hedged until then */
+	std::chrono::milliseconds delay;
+	bool hedged = hedgePolicy.getDelay(delay);
+
+	std::shared_ptr<Hedge> hedge(new Hedge(handlePool, multiEngine, std::move(completion), timing));
+
+	std::unique_ptr<AsyncSend> transfers[2];
+	for(std::size_t index = 0; index < (hedged ? 2 : 1); ++index) {
+		transfers[index].reset(new AsyncSend(handlePool->acquire(), request, Body(), createInput,
+				[hedge, index](const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr) {
+			hedge->done(index, response, exceptionPtr);
+		}, headers));
+		transfers[index]->setTiming(&hedge->timings[index]);
+		transfers[index]->setStartHandler([hedge, index]() {
+			return hedge->claim(index);
+		});
+		transfers[index]->setRecordCheck([hedge, index]() {
+			return hedge->isRecorded(index);
+		});
+	}
+
+	/* locked, so the callbacks on the event loop thread see the ids */
+	std::lock_guard<std::mutex> lock(hedge->mutex);
+
+	hedge->ids[0] = multiEngine->add(std::move(transfers[0]));
+	hedge->remaining = 1;
+
+	if(hedged) {
+		transfers[1]->setStartCheck([hedge]() {
+			return hedge->startHedge();
+		});
+
+		try {
+			hedge->ids[1] = multiEngine->add(std::move(transfers[1]), delay);
+			hedge->remaining = 2;
+		}
+		catch(...) {
+			/* the first send is running already, so it is completed without hedge */
+		}
+	}
+}
+
+Hedge::Hedge(std::shared_ptr<HandlePool> aHandlePool, const std::shared_ptr<MultiEngine>& aMultiEngine, AsyncSend::Completion aCompletion, Timing* aTiming)
+: handlePool(std::move(aHandlePool)),
+  multiEngine(aMultiEngine),
+  completion(std::move(aCompletion)),
+  timing(aTiming),
+  startTime(std::chrono::steady_clock::now())
+{ }
+
+bool Hedge::claim(std::size_t index) {
+	MultiEngine::Id loser = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(winner >= 0) {
+			return false;
+		}
+		winner = static_cast<int>(index);
+		loser = ids[1 - index];
+	}
+
+	handlePool->getHedgePolicy().recordLatency(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime));
+
+	Metrics* metrics = handlePool->getMetrics();
+	if(metrics && index == 1) {
+		metrics->hedgeWon();
+	}
+
+	/* not locked, the engine calls back into done() if the loser has not been started yet */
+	if(loser != 0) {
+		std::shared_ptr<MultiEngine> engine = multiEngine.lock();
+		if(engine) {
+			engine->cancel(loser);
+		}
+	}
+
+	return true;
+}
+
+bool Hedge::startHedge() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(winner >= 0) {
+			return false;
+		}
+	}
+
+	if(!handlePool->getHedgePolicy().tryHedge()) {
+		return false;
+	}
+
+	Metrics* metrics = handlePool->getMetrics();
+	if(metrics) {
+		metrics->hedgeIssued();
+	}
+
+	return true;
+}
+
+bool Hedge::isRecorded(std::size_t index) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return winner < 0 || winner == static_cast<int>(index);
+}
+
+void Hedge::done(std::size_t index, const esl::com::http::client::Response* aResponse, std::exception_ptr exceptionPtr) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		/* result of the loser is dropped */
+		if(winner < 0 || winner == static_cast<int>(index)) {
+			if(aResponse) {
+				response.reset(new esl::com::http::client::Response(*aResponse));
+			}
+			else {
+				exceptionPtrs[index] = exceptionPtr;
+			}
+		}
+
+		if(--remaining > 0) {
+			return;
+		}
+	}
+
+	/* both sends failed before a response has been received, the error of the first send is reported */
+	std::size_t result = winner >= 0 ? static_cast<std::size_t>(winner) : (exceptionPtrs[0] ? 0 : 1);
+
+	if(timing) {
+		*timing = timings[result];
+	}
+
+	if(response) {
+		completion(response.get(), nullptr);
+	}
+	else {
+		completion(nullptr, exceptionPtrs[result]);
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,96 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_HEDGE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_HEDGE_H_
+
+#include <curl4esl/com/http/client/AsyncSend.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/MultiEngine.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/Timing.h>
+
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* A request without body that is sent a second time on another handle, if its
+ * response has not started within the hedge delay. The send that receives the
+ * first response header wins, the other one gets cancelled. Only the winner
+ * calls 'createInput'. The completion is called after both sends are done, so
+ * 'request' and 'headers' only have to stay valid until then. */
+class Hedge {
+public:
+	static void start(std::shared_ptr<HandlePool> handlePool, const std::shared_ptr<MultiEngine>& multiEngine, std::shared_ptr<const PreparedRequest> request,
+			std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, AsyncSend::Completion completion, const PreparedRequest::Headers* headers = nullptr, Timing* timing = nullptr);
+
+private:
+	Hedge(std::shared_ptr<HandlePool> handlePool, const std::shared_ptr<MultiEngine>& multiEngine, AsyncSend::Completion completion, Timing* timing);
+
+	/* start handler of send 'index', returns true if it is the first one */
+	bool claim(std::size_t index);
+
+	/* start check of the second send */
+	bool startHedge();
+
+	/* record check of send 'index', a send that has been cancelled because the other one has won is not recorded */
+	bool isRecorded(std::size_t index);
+
+	void done(std::size_t index, const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr);
+
+	std::shared_ptr<HandlePool> handlePool;
+	std::weak_ptr<MultiEngine> multiEngine;
+	AsyncSend::Completion completion;
+	Timing* timing;
+	std::chrono::steady_clock::time_point startTime;
+
+	std::mutex mutex;
+	/* 0 if the send has not been added to the engine */
+	MultiEngine::Id ids[2] = { 0, 0 };
+	std::size_t remaining = 0;
+	/* index of the send that received the first response header, or -1 */
+	int winner = -1;
+
+	std::unique_ptr<esl::com::http::client::Response> response;
+	std::exception_ptr exceptionPtrs[2];
+	Timing timings[2];
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_HEDGE_H_ */
@@ -0,0 +1,127 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/HedgePolicy.h>
+
+#include <algorithm>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+constexpr std::int64_t windowSeconds = 10;
+constexpr std::size_t maxSamples = 256;
+constexpr std::size_t minSamples = 32;
+/* the adaptive delay is updated after this number of new samples */
+constexpr std::size_t updateInterval = 16;
+
+std::int64_t getCurrentWindow() noexcept {
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count() / windowSeconds;
+}
+}  // anonymer namespace
+
+HedgePolicy::HedgePolicy(const esl::com::http::client::CURLConnectionFactory::Settings& aSettings)
+: settings(aSettings),
+  window(getCurrentWindow())
+{ }
+
+bool HedgePolicy::isEnabled() const noexcept {
+	return settings.hedgeDelay > 0 || settings.hedgeDelayPercentile > 0;
+}
+
+bool HedgePolicy::getDelay(std::chrono::milliseconds& delay) const noexcept {
+	if(settings.hedgeDelayPercentile == 0) {
+		delay = std::chrono::milliseconds(settings.hedgeDelay);
+		return true;
+	}
+
+	std::int64_t microseconds = adaptiveDelay.load(std::memory_order_relaxed);
+	if(microseconds < 0) {
+		return false;
+	}
+
+	/* round up and never hedge immediately */
+	delay = std::chrono::milliseconds(std::max<std::int64_t>((microseconds + 999) / 1000, 1));
+	return true;
+}
+
+void HedgePolicy::recordLatency(std::chrono::microseconds latency) {
+	if(settings.hedgeDelayPercentile == 0) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if(samples.size() < maxSamples) {
+		samples.push_back(latency.count());
+	}
+	else {
+		samples[nextSample] = latency.count();
+	}
+	nextSample = (nextSample + 1) % maxSamples;
+	++newSamples;
+
+	if(samples.size() < minSamples || newSamples < updateInterval) {
+		return;
+	}
+	newSamples = 0;
+
+	std::vector<std::int64_t> sorted(samples);
+	std::size_t index = std::min(sorted.size() * settings.hedgeDelayPercentile / 100, sorted.size() - 1);
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+	adaptiveDelay.store(sorted[index], std::memory_order_relaxed);
+}
+
+void HedgePolicy::recordRequest() noexcept {
+	updateWindow();
+	requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool HedgePolicy::tryHedge() noexcept {
+	updateWindow();
+
+	if(hedges.load(std::memory_order_relaxed) * 100 >= requests.load(std::memory_order_relaxed) * settings.hedgeMaxRate) {
+		return false;
+	}
+
+	hedges.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void HedgePolicy::updateWindow() noexcept {
+	std::int64_t currentWindow = getCurrentWindow();
+	std::int64_t lastWindow = window.load(std::memory_order_relaxed);
+
+	if(lastWindow != currentWindow && window.compare_exchange_strong(lastWindow, currentWindow, std::memory_order_relaxed)) {
+		requests.store(0, std::memory_order_relaxed);
+		hedges.store(0, std::memory_order_relaxed);
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
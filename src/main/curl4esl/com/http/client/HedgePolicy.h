@@ -0,0 +1,88 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_HEDGEPOLICY_H_
+#define CURL4ESL_COM_HTTP_CLIENT_HEDGEPOLICY_H_
+
+#include <esl/com/http/client/CURLConnectionFactory.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Decides when a second send is started for a hedged request. The delay is either
+ * fixed or a percentile of the time until the first response header of recent
+ * hedged requests. Within a window of 10 seconds at most 'hedgeMaxRate' percent
+ * of the requests get hedged, so a slow backend does not get twice the load. */
+class HedgePolicy {
+public:
+	HedgePolicy(const esl::com::http::client::CURLConnectionFactory::Settings& settings);
+
+	bool isEnabled() const noexcept;
+
+	/* returns false if an adaptive delay has not enough samples yet */
+	bool getDelay(std::chrono::milliseconds& delay) const noexcept;
+
+	/* time from start of a hedged request until the first response header */
+	void recordLatency(std::chrono::microseconds latency);
+
+	void recordRequest() noexcept;
+
+	/* returns true and counts the hedge if the rate allows another hedge */
+	bool tryHedge() noexcept;
+
+private:
+	/* starts a new window if the current one is over */
+	void updateWindow() noexcept;
+
+	const esl::com::http::client::CURLConnectionFactory::Settings& settings;
+
+	std::mutex mutex;
+	/* ring buffer of recent latencies in microseconds */
+	std::vector<std::int64_t> samples;
+	std::size_t nextSample = 0;
+	std::size_t newSamples = 0;
+
+	/* microseconds, negative if unknown */
+	std::atomic<std::int64_t> adaptiveDelay { -1 };
+
+	std::atomic<std::int64_t> window { 0 };
+	std::atomic<std::uint64_t> requests { 0 };
+	std::atomic<std::uint64_t> hedges { 0 };
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_HEDGEPOLICY_H_ */
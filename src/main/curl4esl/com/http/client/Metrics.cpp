@@ -0,0 +1,250 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/Metrics.h>
+
+#include <cmath>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+unsigned int getHighestBit(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return 63u - static_cast<unsigned int>(__builtin_clzll(value));
+#else
+	unsigned int bit = 0;
+	while(value >>= 1) {
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+	counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t load(const std::atomic<std::uint64_t>& counter) noexcept {
+	return counter.load(std::memory_order_relaxed);
+}
+
+std::uint64_t getOffValue(CURL* curl, CURLINFO info) noexcept {
+	curl_off_t value = 0;
+	if(curl_easy_getinfo(curl, info, &value) != CURLE_OK || value < 0) {
+		return 0;
+	}
+	return static_cast<std::uint64_t>(value);
+}
+}  // anonymer namespace
+
+constexpr unsigned int Metrics::Histogram::subBucketBits;
+constexpr std::size_t Metrics::Histogram::subBucketCount;
+constexpr unsigned int Metrics::Histogram::maxExponent;
+constexpr std::size_t Metrics::Histogram::bucketCount;
+
+std::uint64_t Metrics::Histogram::Snapshot::getPercentile(double p) const {
+	if(count == 0) {
+		return 0;
+	}
+
+	if(p < 0.0) {
+		p = 0.0;
+	}
+	else if(p > 100.0) {
+		p = 100.0;
+	}
+
+	std::uint64_t target = static_cast<std::uint64_t>(std::ceil(p / 100.0 * static_cast<double>(count)));
+	if(target == 0) {
+		target = 1;
+	}
+
+	std::uint64_t cumulated = 0;
+	for(std::size_t index = 0; index < counts.size(); ++index) {
+		cumulated += counts[index];
+		if(cumulated >= target) {
+			std::uint64_t value = getHighestEquivalentValue(index);
+			return value < max ? value : max;
+		}
+	}
+
+	return max;
+}
+
+double Metrics::Histogram::Snapshot::getMean() const {
+	return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+Metrics::Histogram::Histogram() {
+	for(auto& counter : counts) {
+		counter.store(0, std::memory_order_relaxed);
+	}
+}
+
+void Metrics::Histogram::record(std::uint64_t value) noexcept {
+	add(counts[getIndex(value)], 1);
+	add(count, 1);
+	add(sum, value);
+
+	std::uint64_t currentMax = load(max);
+	while(value > currentMax && !max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+	}
+}
+
+Metrics::Histogram::Snapshot Metrics::Histogram::getSnapshot() const {
+	Snapshot snapshot;
+
+	snapshot.counts.resize(bucketCount);
+	for(std::size_t index = 0; index < bucketCount; ++index) {
+		snapshot.counts[index] = load(counts[index]);
+		snapshot.count += snapshot.counts[index];
+	}
+	snapshot.sum = load(sum);
+	snapshot.max = load(max);
+
+	return snapshot;
+}
+
+std::size_t Metrics::Histogram::getIndex(std::uint64_t value) noexcept {
+	if(value < 2 * subBucketCount) {
+		return static_cast<std::size_t>(value);
+	}
+
+	unsigned int exponent = getHighestBit(value);
+	if(exponent > maxExponent) {
+		return bucketCount - 1;
+	}
+
+	unsigned int shift = exponent - subBucketBits;
+	std::size_t subBucket = static_cast<std::size_t>(value >> shift) - subBucketCount;
+	return 2 * subBucketCount + (exponent - subBucketBits - 1) * subBucketCount + subBucket;
+}
+
+std::uint64_t Metrics::Histogram::getHighestEquivalentValue(std::size_t index) noexcept {
+	if(index < 2 * subBucketCount) {
+		return index;
+	}
+
+	std::size_t offset = index - 2 * subBucketCount;
+	unsigned int shift = static_cast<unsigned int>(offset / subBucketCount) + 1;
+	std::uint64_t subBucket = offset % subBucketCount;
+	return ((subBucketCount + subBucket + 1) << shift) - 1;
+}
+
+Metrics::Metrics() {
+	for(auto& counter : requestsByStatusClass) {
+		counter.store(0, std::memory_order_relaxed);
+	}
+	for(auto& counter : curlErrors) {
+		counter.store(0, std::memory_order_relaxed);
+	}
+}
+
+void Metrics::record(CURL* curl, CURLcode rc) noexcept {
+	long statusCode = 0;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+	std::size_t statusClass = static_cast<std::size_t>(statusCode / 100);
+	add(requestsByStatusClass[statusClass < 6 ? statusClass : 0], 1);
+
+	if(rc != CURLE_OK && rc < CURL_LAST) {
+		add(curlErrors[rc], 1);
+	}
+
+	add(bytesSent, getOffValue(curl, CURLINFO_SIZE_UPLOAD_T));
+	add(bytesReceived, getOffValue(curl, CURLINFO_SIZE_DOWNLOAD_T));
+
+	long numConnects = 0;
+	curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &numConnects);
+	if(numConnects > 0) {
+		add(newConnections, static_cast<std::uint64_t>(numConnects));
+	}
+	else if(rc == CURLE_OK) {
+		add(reusedConnections, 1);
+	}
+
+	/* phases of failed transfers are incomplete, a transfer that has not reached pretransfer has 0 for all of them */
+	std::uint64_t preTransferTime = getOffValue(curl, CURLINFO_PRETRANSFER_TIME_T);
+	if(rc != CURLE_OK || preTransferTime == 0) {
+		return;
+	}
+
+	latency[nameLookup].record(getOffValue(curl, CURLINFO_NAMELOOKUP_TIME_T));
+	latency[connect].record(getOffValue(curl, CURLINFO_CONNECT_TIME_T));
+	latency[appConnect].record(getOffValue(curl, CURLINFO_APPCONNECT_TIME_T));
+	latency[preTransfer].record(preTransferTime);
+	latency[startTransfer].record(getOffValue(curl, CURLINFO_STARTTRANSFER_TIME_T));
+	latency[total].record(getOffValue(curl, CURLINFO_TOTAL_TIME_T));
+}
+
+void Metrics::handleAcquired() noexcept {
+	add(activeHandles, 1);
+}
+
+void Metrics::handleReleased() noexcept {
+	activeHandles.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Metrics::hedgeIssued() noexcept {
+	add(hedgesIssuedCount, 1);
+}
+
+void Metrics::hedgeWon() noexcept {
+	add(hedgesWonCount, 1);
+}
+
+Metrics::Snapshot Metrics::getSnapshot() const {
+	Snapshot snapshot;
+
+	for(std::size_t i = 0; i < 6; ++i) {
+		snapshot.requestsByStatusClass[i] = load(requestsByStatusClass[i]);
+	}
+	for(int code = 1; code < CURL_LAST; ++code) {
+		std::uint64_t value = load(curlErrors[code]);
+		if(value > 0) {
+			snapshot.curlErrors[code] = value;
+		}
+	}
+
+	snapshot.bytesSent = load(bytesSent);
+	snapshot.bytesReceived = load(bytesReceived);
+	snapshot.newConnections = load(newConnections);
+	snapshot.reusedConnections = load(reusedConnections);
+	snapshot.activeHandles = load(activeHandles);
+	snapshot.hedgesIssued = load(hedgesIssuedCount);
+	snapshot.hedgesWon = load(hedgesWonCount);
+
+	for(std::size_t phase = 0; phase < phaseCount; ++phase) {
+		snapshot.latency[phase] = latency[phase].getSnapshot();
+	}
+
+	return snapshot;
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
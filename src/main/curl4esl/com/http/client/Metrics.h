@@ -0,0 +1,156 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_METRICS_H_
+#define CURL4ESL_COM_HTTP_CLIENT_METRICS_H_
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Lock free counters and latency histograms of all transfers of a ConnectionFactory.
+ * Recording uses relaxed atomics only, a snapshot can be taken at any time
+ * without stopping traffic. */
+class Metrics {
+public:
+	/* Log-linear histogram of microsecond values like HdrHistogram:
+	 * values below 64 are exact, larger values are recorded with 32 buckets
+	 * per power of two, i.e. with a relative error below 3.2%. */
+	class Histogram {
+	public:
+		static constexpr unsigned int subBucketBits = 5;
+		static constexpr std::size_t subBucketCount = std::size_t(1) << subBucketBits;
+		/* largest power of two that is recorded, larger values are counted in the last bucket */
+		static constexpr unsigned int maxExponent = 40;
+		static constexpr std::size_t bucketCount = 2 * subBucketCount + (maxExponent - subBucketBits) * subBucketCount;
+
+		struct Snapshot {
+			std::vector<std::uint64_t> counts;
+			std::uint64_t count = 0;
+			std::uint64_t sum = 0;
+			std::uint64_t max = 0;
+
+			/* returns the highest value that is equivalent to the value at percentile 'p' (0..100) */
+			std::uint64_t getPercentile(double p) const;
+			double getMean() const;
+		};
+
+		Histogram();
+
+		void record(std::uint64_t value) noexcept;
+		Snapshot getSnapshot() const;
+
+		static std::size_t getIndex(std::uint64_t value) noexcept;
+		static std::uint64_t getHighestEquivalentValue(std::size_t index) noexcept;
+
+	private:
+		std::atomic<std::uint64_t> counts[bucketCount];
+		std::atomic<std::uint64_t> count { 0 };
+		std::atomic<std::uint64_t> sum { 0 };
+		std::atomic<std::uint64_t> max { 0 };
+	};
+
+	enum Phase {
+		nameLookup,
+		connect,
+		appConnect,
+		preTransfer,
+		startTransfer,
+		total,
+		phaseCount
+	};
+
+	struct Snapshot {
+		/* index 0 counts transfers without response, index 1..5 counts status classes 1xx..5xx.
+		 * A hedged send that has been cancelled, because the other send has won, is not counted. */
+		std::uint64_t requestsByStatusClass[6] = {0, 0, 0, 0, 0, 0};
+		/* transfers by CURLcode, CURLE_OK is not contained */
+		std::map<int, std::uint64_t> curlErrors;
+
+		std::uint64_t bytesSent = 0;
+		std::uint64_t bytesReceived = 0;
+
+		std::uint64_t newConnections = 0;
+		std::uint64_t reusedConnections = 0;
+
+		/* handles borrowed from and kept in the handle pool */
+		std::uint64_t activeHandles = 0;
+		std::uint64_t idleHandles = 0;
+
+		/* second sends started by hedging and how many of them have been faster than the first send */
+		std::uint64_t hedgesIssued = 0;
+		std::uint64_t hedgesWon = 0;
+
+		/* phases of successful transfers */
+		Histogram::Snapshot latency[phaseCount];
+	};
+
+	Metrics();
+
+	/* Records the result of a transfer that has been performed by 'curl'.
+	 * Latencies are only recorded for successful transfers. */
+	void record(CURL* curl, CURLcode rc) noexcept;
+
+	void handleAcquired() noexcept;
+	void handleReleased() noexcept;
+
+	void hedgeIssued() noexcept;
+	void hedgeWon() noexcept;
+
+	/* 'idleHandles' is not known by Metrics and must be set by the caller */
+	Snapshot getSnapshot() const;
+
+private:
+	std::atomic<std::uint64_t> requestsByStatusClass[6];
+	std::atomic<std::uint64_t> curlErrors[CURL_LAST];
+
+	std::atomic<std::uint64_t> bytesSent { 0 };
+	std::atomic<std::uint64_t> bytesReceived { 0 };
+
+	std::atomic<std::uint64_t> newConnections { 0 };
+	std::atomic<std::uint64_t> reusedConnections { 0 };
+
+	std::atomic<std::uint64_t> activeHandles { 0 };
+
+	std::atomic<std::uint64_t> hedgesIssuedCount { 0 };
+	std::atomic<std::uint64_t> hedgesWonCount { 0 };
+
+	Histogram latency[phaseCount];
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_METRICS_H_ */
@@ -0,0 +1,320 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/MultiEngine.h>
+
+#include <esl/Logger.h>
+#include <esl/system/Stacktrace.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+esl::Logger logger("curl4esl::com::http::client::MultiEngine");
+
+/* interval to call stalled writers of finished transfers again */
+constexpr int drainInterval = 10;
+}  // anonymer namespace
+
+MultiEngine::State::State(bool multiplex, long maxConcurrentStreams, long maxConnects)
+: multi(curl_multi_init())
+{
+	if(multi == nullptr) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl multi init error"));
+	}
+
+	if(multiplex) {
+		curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+		curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, maxConcurrentStreams);
+	}
+
+	if(maxConnects > 0) {
+		curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, maxConnects);
+	}
+}
+
+MultiEngine::State::~State() {
+	for(auto& entry : running) {
+		curl_multi_remove_handle(multi, entry.first);
+		done(std::move(entry.second.transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	running.clear();
+
+	for(auto& entry : draining) {
+		done(std::move(entry.transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	draining.clear();
+
+	for(auto& entry : delayed) {
+		done(std::move(entry.transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	delayed.clear();
+
+	for(auto& entry : pending) {
+		done(std::move(entry.transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	pending.clear();
+
+	curl_multi_cleanup(multi);
+}
+
+MultiEngine::MultiEngine(bool multiplex, long maxConcurrentStreams, long maxConnects)
+: state(std::make_shared<State>(multiplex, maxConcurrentStreams, maxConnects))
+{ }
+
+MultiEngine::~MultiEngine() {
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->stopped = true;
+	}
+	curl_multi_wakeup(state->multi);
+
+	if(thread.joinable()) {
+		if(thread.get_id() == std::this_thread::get_id()) {
+			thread.detach();
+		}
+		else {
+			thread.join();
+		}
+	}
+}
+
+MultiEngine::Id MultiEngine::add(std::unique_ptr<Transfer> transfer) {
+	return add(std::move(transfer), std::chrono::milliseconds(0));
+}
+
+MultiEngine::Id MultiEngine::add(std::unique_ptr<Transfer> transfer, std::chrono::milliseconds delay) {
+	Entry entry;
+	entry.startTime = std::chrono::steady_clock::now() + delay;
+	entry.transfer = std::move(transfer);
+
+	Id id;
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if(state->stopped) {
+	        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: transfer added to stopped engine"));
+		}
+		id = ++state->lastId;
+		entry.id = id;
+		state->pending.push_back(std::move(entry));
+
+		if(!thread.joinable()) {
+			thread = std::thread(run, state);
+		}
+	}
+	curl_multi_wakeup(state->multi);
+
+	return id;
+}
+
+void MultiEngine::cancel(Id id) {
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->cancelled.push_back(id);
+	}
+	curl_multi_wakeup(state->multi);
+}
+
+void MultiEngine::run(std::shared_ptr<State> state) {
+	std::vector<Entry> added;
+	std::vector<Id> cancelled;
+
+	while(true) {
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if(state->stopped) {
+				break;
+			}
+			added.swap(state->pending);
+			cancelled.swap(state->cancelled);
+		}
+
+		/* ids are never reused, so a cancel of a transfer that has been done already is ignored */
+		for(auto id : cancelled) {
+			if(cancel(added, id) || cancel(state->delayed, id) || cancel(state->draining, id)) {
+				continue;
+			}
+			for(auto iter = state->running.begin(); iter != state->running.end(); ++iter) {
+				if(iter->second.id == id) {
+					std::unique_ptr<Transfer> transfer = std::move(iter->second.transfer);
+					curl_multi_remove_handle(state->multi, iter->first);
+					state->running.erase(iter);
+					done(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+					break;
+				}
+			}
+		}
+		cancelled.clear();
+
+		auto now = std::chrono::steady_clock::now();
+		for(auto& entry : added) {
+			if(entry.startTime > now) {
+				state->delayed.push_back(std::move(entry));
+			}
+			else {
+				start(*state, std::move(entry));
+			}
+		}
+		added.clear();
+
+		int timeout = 1000;
+		for(std::size_t i = 0; i < state->delayed.size();) {
+			if(state->delayed[i].startTime <= now) {
+				Entry entry = std::move(state->delayed[i]);
+				state->delayed.erase(state->delayed.begin() + i);
+				start(*state, std::move(entry));
+				continue;
+			}
+
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(state->delayed[i].startTime - now).count() + 1;
+			if(remaining < timeout) {
+				timeout = static_cast<int>(remaining);
+			}
+			++i;
+		}
+
+		int stillRunning = 0;
+		curl_multi_perform(state->multi, &stillRunning);
+
+		int messagesLeft = 0;
+		while(CURLMsg* message = curl_multi_info_read(state->multi, &messagesLeft)) {
+			if(message->msg != CURLMSG_DONE) {
+				continue;
+			}
+
+			CURL* curl = message->easy_handle;
+			CURLcode code = message->data.result;
+			curl_multi_remove_handle(state->multi, curl);
+
+			auto iter = state->running.find(curl);
+			if(iter != state->running.end()) {
+				Entry entry = std::move(iter->second);
+				state->running.erase(iter);
+				finish(*state, std::move(entry), code);
+			}
+		}
+
+		/* completions may add new transfers, so they are not called while iterating */
+		std::vector<Entry> drained;
+		for(std::size_t i = 0; i < state->draining.size();) {
+			if(drain(*state->draining[i].transfer)) {
+				drained.push_back(std::move(state->draining[i]));
+				state->draining.erase(state->draining.begin() + i);
+				continue;
+			}
+			++i;
+		}
+		for(auto& entry : drained) {
+			done(std::move(entry.transfer), CURLE_OK);
+		}
+
+		if(!state->draining.empty() && drainInterval < timeout) {
+			timeout = drainInterval;
+		}
+
+		curl_multi_poll(state->multi, nullptr, 0, timeout, nullptr);
+	}
+}
+
+void MultiEngine::start(State& state, Entry entry) {
+	bool started = false;
+	try {
+		started = entry.transfer->start();
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in start of transfer: " << e.what() << "\n";
+	}
+	catch(...) {
+		logger.warn << "unknown exception in start of transfer\n";
+	}
+
+	if(!started) {
+		done(std::move(entry.transfer), CURLE_ABORTED_BY_CALLBACK);
+		return;
+	}
+
+	CURL* curl = entry.transfer->getHandle();
+	CURLMcode mc = curl_multi_add_handle(state.multi, curl);
+	if(mc != CURLM_OK) {
+		logger.warn << "curl_multi_add_handle failed: " << curl_multi_strerror(mc) << "\n";
+		done(std::move(entry.transfer), CURLE_FAILED_INIT);
+		return;
+	}
+	state.running[curl] = std::move(entry);
+}
+
+void MultiEngine::finish(State& state, Entry entry, CURLcode code) {
+	if(code == CURLE_OK && !drain(*entry.transfer)) {
+		state.draining.push_back(std::move(entry));
+		return;
+	}
+	done(std::move(entry.transfer), code);
+}
+
+bool MultiEngine::drain(Transfer& transfer) {
+	try {
+		return transfer.drain();
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in drain of transfer: " << e.what() << "\n";
+	}
+	catch(...) {
+		logger.warn << "unknown exception in drain of transfer\n";
+	}
+	return true;
+}
+
+bool MultiEngine::cancel(std::vector<Entry>& entries, Id id) {
+	for(auto iter = entries.begin(); iter != entries.end(); ++iter) {
+		if(iter->id == id) {
+			std::unique_ptr<Transfer> transfer = std::move(iter->transfer);
+			entries.erase(iter);
+			done(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+			return true;
+		}
+	}
+	return false;
+}
+
+void MultiEngine::done(std::unique_ptr<Transfer> transfer, CURLcode code) {
+	try {
+		transfer->done(code);
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in completion of transfer: " << e.what() << "\n";
+	}
+	catch(...) {
+		logger.warn << "unknown exception in completion of transfer\n";
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,147 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_MULTIENGINE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_MULTIENGINE_H_
+
+#include <curl/curl.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Drives a curl_multi handle on a dedicated event loop thread, so many
+ * transfers can be in flight without blocking a thread per transfer.
+ * The thread is started when the first transfer is added. */
+class MultiEngine {
+public:
+	class Transfer {
+	public:
+		virtual ~Transfer() = default;
+
+		virtual CURL* getHandle() const = 0;
+
+		/* Called on the event loop thread before the transfer is added to the multi handle.
+		 * If it returns false, the transfer is not performed and done with CURLE_ABORTED_BY_CALLBACK. */
+		virtual bool start() {
+			return true;
+		}
+
+		/* Called periodically for running transfers by engines that do not call the progress callback of
+		 * paused transfers. If it returns false, the transfer is done with CURLE_ABORTED_BY_CALLBACK. */
+		virtual bool resume() {
+			return true;
+		}
+
+		/* returns true if the transfer has been paused, e.g. because its writer is stalled */
+		virtual bool isPaused() const {
+			return false;
+		}
+
+		/* Called on the event loop thread when the transfer has finished successfully, before done(...).
+		 * If it returns false, data is still queued for a stalled writer and it is called again later. */
+		virtual bool drain() {
+			return true;
+		}
+
+		/* Called on the event loop thread when the transfer has finished.
+		 * If the engine is destroyed before or the transfer has been cancelled, it is called with CURLE_ABORTED_BY_CALLBACK. */
+		virtual void done(CURLcode code) = 0;
+	};
+
+	/* unique for all transfers of an engine, it is never reused */
+	using Id = std::uint64_t;
+
+	MultiEngine(bool multiplex, long maxConcurrentStreams, long maxConnects);
+	MultiEngine(const MultiEngine&) = delete;
+	~MultiEngine();
+
+	MultiEngine& operator=(const MultiEngine&) = delete;
+
+	Id add(std::unique_ptr<Transfer> transfer);
+
+	/* the transfer is started when 'delay' has elapsed */
+	Id add(std::unique_ptr<Transfer> transfer, std::chrono::milliseconds delay);
+
+	/* Aborts a transfer that has not been done yet, it is done with CURLE_ABORTED_BY_CALLBACK.
+	 * May be called from any thread, including callbacks of transfers on the event loop thread. */
+	void cancel(Id id);
+
+private:
+	struct Entry {
+		Id id = 0;
+		std::chrono::steady_clock::time_point startTime;
+		std::unique_ptr<Transfer> transfer;
+	};
+
+	/* shared with the event loop thread, so the thread can outlive the engine
+	 * if the engine gets destroyed from within a completion callback */
+	struct State {
+		State(bool multiplex, long maxConcurrentStreams, long maxConnects);
+		~State();
+
+		CURLM* multi = nullptr;
+
+		std::mutex mutex;
+		bool stopped = false;
+		Id lastId = 0;
+		std::vector<Entry> pending;
+		std::vector<Id> cancelled;
+
+		/* accessed by event loop thread only */
+		std::vector<Entry> delayed;
+		std::map<CURL*, Entry> running;
+		/* finished transfers waiting for a stalled writer */
+		std::vector<Entry> draining;
+	};
+
+	static void run(std::shared_ptr<State> state);
+	static void start(State& state, Entry entry);
+	/* completes a finished transfer or keeps it for draining */
+	static void finish(State& state, Entry entry, CURLcode code);
+	/* returns true if the writer of the transfer has taken all data */
+	static bool drain(Transfer& transfer);
+	/* returns true if the transfer has been found */
+	static bool cancel(std::vector<Entry>& entries, Id id);
+	static void done(std::unique_ptr<Transfer> transfer, CURLcode code);
+
+	std::shared_ptr<State> state;
+	std::thread thread;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_MULTIENGINE_H_ */
@@ -0,0 +1,179 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/Pipeline.h>
+
+#include <esl/io/Writer.h>
+#include <esl/com/http/client/exception/NetworkError.h>
+#include <esl/system/Stacktrace.h>
+
+#include <curl/curl.h>
+
+#include <string>
+
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+Pipeline::Pipeline(esl::io::Input aInput, std::vector<std::vector<std::uint8_t>>& aBuffers, std::size_t aDepth, std::chrono::milliseconds stallTimeout)
+: input(std::move(aInput)),
+  buffers(aBuffers),
+  depth(aDepth),
+  writerStall(stallTimeout)
+{
+	if(buffers.size() < depth) {
+		buffers.resize(depth);
+	}
+	thread = std::thread(&Pipeline::run, this);
+}
+
+Pipeline::~Pipeline() {
+	if(thread.joinable()) {
+		closed = true;
+		finished = true;
+		notify();
+		thread.join();
+	}
+}
+
+bool Pipeline::push(const std::uint8_t* data, std::size_t size) {
+	std::size_t currentTail = tail.load(std::memory_order_relaxed);
+
+	while(!closed && currentTail - head.load(std::memory_order_acquire) == depth) {
+		std::unique_lock<std::mutex> lock(mutex);
+		producerWaiting = true;
+		condition.wait(lock, [this, currentTail] {
+			return closed || currentTail - head.load() < depth;
+		});
+		producerWaiting = false;
+	}
+
+	if(closed) {
+		if(exceptionPtr) {
+			std::rethrow_exception(exceptionPtr);
+		}
+		return false;
+	}
+
+	/* assign keeps the capacity of the buffer */
+	buffers[currentTail % depth].assign(data, data + size);
+	tail = currentTail + 1;
+
+	if(consumerWaiting) {
+		notify();
+	}
+
+	return true;
+}
+
+bool Pipeline::finish() {
+	finished = true;
+	notify();
+	thread.join();
+
+	if(exceptionPtr) {
+		std::rethrow_exception(exceptionPtr);
+	}
+	return !closed;
+}
+
+void Pipeline::run() {
+	while(true) {
+		std::size_t currentHead = head.load(std::memory_order_relaxed);
+
+		if(currentHead == tail.load(std::memory_order_acquire)) {
+			/* 'finished' is set after the last chunk, so 'tail' is final if it has been set */
+			if(finished && currentHead == tail.load()) {
+				break;
+			}
+
+			std::unique_lock<std::mutex> lock(mutex);
+			consumerWaiting = true;
+			condition.wait(lock, [this, currentHead] {
+				return finished || currentHead != tail.load();
+			});
+			consumerWaiting = false;
+			continue;
+		}
+
+		/* chunks are still consumed after the writer has been closed, so the producer does not block */
+		if(!closed) {
+			write(buffers[currentHead % depth]);
+		}
+		head = currentHead + 1;
+
+		if(producerWaiting) {
+			notify();
+		}
+	}
+}
+
+void Pipeline::write(const std::vector<std::uint8_t>& chunk) {
+	try {
+		std::size_t currentPos = 0;
+		while(currentPos < chunk.size()) {
+			std::size_t sizeWritten = input.getWriter().write(&chunk[currentPos], chunk.size() - currentPos);
+
+			if(sizeWritten == esl::io::Writer::npos) {
+				closed = true;
+				return;
+			}
+
+			/* writer is stalled, the destructor wakes up the consumer to close the pipeline */
+			if(sizeWritten == 0) {
+				if(!writerStall.stall()) {
+					std::string str = "Fehlercode=" + std::to_string(CURLE_WRITE_ERROR) + " (" + curl_easy_strerror(CURLE_WRITE_ERROR) + ") writer has not taken the rest of the response body";
+					throw esl::system::Stacktrace::add(esl::com::http::client::exception::NetworkError(static_cast<int>(CURLE_WRITE_ERROR), str));
+				}
+
+				std::unique_lock<std::mutex> lock(mutex);
+				if(condition.wait_for(lock, writerStall.getBackoff(), [this] { return closed.load(); })) {
+					return;
+				}
+				continue;
+			}
+
+			writerStall.reset();
+			currentPos += sizeWritten;
+		}
+	}
+	catch(...) {
+		exceptionPtr = std::current_exception();
+		closed = true;
+	}
+}
+
+void Pipeline::notify() {
+	/* the lock makes sure that a waiting thread is either waiting already or checks its condition afterwards */
+	std::lock_guard<std::mutex> lock(mutex);
+	condition.notify_all();
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,104 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_PIPELINE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_PIPELINE_H_
+
+#include <curl4esl/com/http/client/WriterStall.h>
+
+#include <esl/io/Input.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Passes received data to the writer of an input on a consumer thread of its own,
+ * so receiving and processing of the body overlap. Chunks are copied into pooled
+ * buffers that are handed over by a bounded single-producer/single-consumer queue.
+ * Producer and consumer only synchronize by atomics, unless one of them has to wait
+ * because the queue is full or empty. A stalled writer is called again after a backoff
+ * and given up with a network error if it has not taken data for 'stallTimeout'. */
+class Pipeline {
+public:
+	/* 'buffers' are reused for following transfers and must outlive the pipeline */
+	Pipeline(esl::io::Input input, std::vector<std::vector<std::uint8_t>>& buffers, std::size_t depth, std::chrono::milliseconds stallTimeout);
+	Pipeline(const Pipeline&) = delete;
+	/* data that has not been written yet is dropped */
+	~Pipeline();
+
+	Pipeline& operator=(const Pipeline&) = delete;
+
+	/* Blocks while the queue is full. Returns false if the writer does not want more data.
+	 * Rethrows an exception of the writer. */
+	bool push(const std::uint8_t* data, std::size_t size);
+
+	/* Waits until the writer has written all queued data and rethrows its exception.
+	 * Returns false if the writer has stopped before. */
+	bool finish();
+
+private:
+	void run();
+	void write(const std::vector<std::uint8_t>& chunk);
+	void notify();
+
+	esl::io::Input input;
+	std::vector<std::vector<std::uint8_t>>& buffers;
+	std::size_t depth;
+	WriterStall writerStall;
+
+	/* next chunk of the consumer and next free slot of the producer, the queue is full if they differ by 'depth' */
+	std::atomic<std::size_t> head { 0 };
+	std::atomic<std::size_t> tail { 0 };
+
+	/* set by the consumer if the writer does not want more data, 'exceptionPtr' is written before */
+	std::atomic<bool> closed { false };
+	std::exception_ptr exceptionPtr;
+	/* set by the producer after the last chunk */
+	std::atomic<bool> finished { false };
+
+	std::atomic<bool> producerWaiting { false };
+	std::atomic<bool> consumerWaiting { false };
+	std::mutex mutex;
+	std::condition_variable condition;
+
+	std::thread thread;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_PIPELINE_H_ */
@@ -0,0 +1,107 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+
+#include <cstring>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+PreparedRequest::PreparedRequest(const std::string& hostUrl, const esl::com::http::client::Request& request) {
+	assign(hostUrl, request);
+}
+
+void PreparedRequest::assign(const std::string& hostUrl, const esl::com::http::client::Request& request) {
+	const std::string& path = request.getPath();
+	bool addSlash = path.empty() == false && path.at(0) != '/';
+
+	/* assign keeps the capacity of a reused object */
+	url.reserve(hostUrl.size() + (addSlash ? 1 : 0) + path.size());
+	url.assign(hostUrl);
+	if(addSlash) {
+		url += '/';
+	}
+	url += path;
+
+	method = request.getMethod().toString();
+
+	headers.clear();
+
+	/* add content-type header */
+	if(request.getContentType()) {
+		headers.add("Content-Type", request.getContentType().toString());
+	}
+
+	/* add other headers */
+	for(const auto& v : request.getHeaders()) {
+		headers.add(v.first, v.second);
+	}
+}
+
+const std::string& PreparedRequest::getUrl() const noexcept {
+	return url;
+}
+
+const std::string& PreparedRequest::getMethod() const noexcept {
+	return method;
+}
+
+curl_slist* PreparedRequest::getHeaders() const noexcept {
+	return headers.getHead();
+}
+
+bool PreparedRequest::findHeader(const std::string& key, std::string& value) const {
+	for(const curl_slist* header = headers.getHead(); header; header = header->next) {
+		const char* data = header->data;
+		std::size_t length = std::strlen(data);
+
+		/* "key: value" or "key;" for an empty value */
+		const char* separator = static_cast<const char*>(std::memchr(data, ':', length));
+		if(separator == nullptr) {
+			separator = static_cast<const char*>(std::memchr(data, ';', length));
+		}
+		if(separator == nullptr || !HeaderStore::equalsIgnoreCase(data, static_cast<std::size_t>(separator - data), key.data(), key.size())) {
+			continue;
+		}
+
+		const char* begin = separator + 1;
+		const char* end = data + length;
+		while(begin < end && (*begin == ' ' || *begin == '\t')) {
+			++begin;
+		}
+		value.assign(begin, end);
+		return true;
+	}
+
+	return false;
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,81 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_PREPAREDREQUEST_H_
+#define CURL4ESL_COM_HTTP_CLIENT_PREPAREDREQUEST_H_
+
+#include <esl/com/http/client/Request.h>
+
+#include <curl4esl/com/http/client/HeaderList.h>
+
+#include <curl/curl.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* URL, method and header list of a request, built once so the request
+ * can be sent repeatedly without setting it up again. A reused object keeps
+ * the memory of its URL and header list when it is assigned another request. */
+class PreparedRequest {
+public:
+	/* additional headers of a single send */
+	using Headers = std::vector<std::pair<std::string, std::string>>;
+
+	PreparedRequest() = default;
+	PreparedRequest(const std::string& hostUrl, const esl::com::http::client::Request& request);
+	PreparedRequest(const PreparedRequest&) = delete;
+	PreparedRequest(PreparedRequest&& other) = default;
+
+	PreparedRequest& operator=(const PreparedRequest&) = delete;
+	PreparedRequest& operator=(PreparedRequest&& other) = default;
+
+	void assign(const std::string& hostUrl, const esl::com::http::client::Request& request);
+
+	const std::string& getUrl() const noexcept;
+	const std::string& getMethod() const noexcept;
+
+	/* header list for CURLOPT_HTTPHEADER, it must not be modified */
+	curl_slist* getHeaders() const noexcept;
+
+	/* looks up the value of the first header with this name, the name is case insensitive */
+	bool findHeader(const std::string& key, std::string& value) const;
+
+private:
+	std::string url;
+	std::string method;
+	HeaderList headers;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_PREPAREDREQUEST_H_ */
@@ -0,0 +1,114 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/ReceiveBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+constexpr std::size_t minimumCapacity = 16 * 1024;
+}  // anonymer namespace
+
+bool ReceiveBuffer::empty() const noexcept {
+	return length == 0;
+}
+
+std::size_t ReceiveBuffer::size() const noexcept {
+	return length;
+}
+
+std::size_t ReceiveBuffer::capacity() const noexcept {
+	return buffer.size();
+}
+
+const std::uint8_t* ReceiveBuffer::front(std::size_t& aLength) const noexcept {
+	aLength = std::min(length, buffer.size() - head);
+	return length == 0 ? nullptr : &buffer[head];
+}
+
+void ReceiveBuffer::consume(std::size_t aLength) noexcept {
+	aLength = std::min(aLength, length);
+	length -= aLength;
+	head = (length == 0) ? 0 : (head + aLength) % buffer.size();
+}
+
+void ReceiveBuffer::append(const std::uint8_t* data, std::size_t aLength) {
+	if(aLength == 0) {
+		return;
+	}
+
+	if(length + aLength > buffer.size()) {
+		grow(length + aLength);
+	}
+
+	std::size_t tail = (head + length) % buffer.size();
+	std::size_t firstLength = std::min(aLength, buffer.size() - tail);
+	std::memcpy(&buffer[tail], data, firstLength);
+	if(firstLength < aLength) {
+		std::memcpy(&buffer[0], data + firstLength, aLength - firstLength);
+	}
+	length += aLength;
+}
+
+void ReceiveBuffer::clear() noexcept {
+	head = 0;
+	length = 0;
+}
+
+void ReceiveBuffer::shrink(std::size_t maxCapacity) {
+	if(buffer.size() > maxCapacity && length == 0) {
+		std::vector<std::uint8_t>().swap(buffer);
+		head = 0;
+	}
+}
+
+void ReceiveBuffer::grow(std::size_t minCapacity) {
+	std::size_t newCapacity = std::max(buffer.size(), minimumCapacity);
+	while(newCapacity < minCapacity) {
+		newCapacity *= 2;
+	}
+
+	std::vector<std::uint8_t> newBuffer(newCapacity);
+	std::size_t firstLength = std::min(length, buffer.size() - head);
+	if(firstLength > 0) {
+		std::memcpy(&newBuffer[0], &buffer[head], firstLength);
+	}
+	if(firstLength < length) {
+		std::memcpy(&newBuffer[firstLength], &buffer[0], length - firstLength);
+	}
+
+	buffer.swap(newBuffer);
+	head = 0;
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
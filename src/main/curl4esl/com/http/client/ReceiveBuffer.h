@@ -0,0 +1,73 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_RECEIVEBUFFER_H_
+#define CURL4ESL_COM_HTTP_CLIENT_RECEIVEBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Growable ring buffer for received data that could not be written yet.
+ * Memory is kept when the buffer gets empty, so it is allocation free
+ * in steady state if it is reused for following transfers. */
+class ReceiveBuffer {
+public:
+	bool empty() const noexcept;
+	std::size_t size() const noexcept;
+	std::size_t capacity() const noexcept;
+
+	/* returns the first contiguous block of buffered data */
+	const std::uint8_t* front(std::size_t& length) const noexcept;
+
+	/* removes 'length' bytes from front */
+	void consume(std::size_t length) noexcept;
+
+	void append(const std::uint8_t* data, std::size_t length);
+
+	/* removes all data, but keeps the memory */
+	void clear() noexcept;
+
+	/* releases the memory if capacity is larger than 'maxCapacity' */
+	void shrink(std::size_t maxCapacity);
+
+private:
+	void grow(std::size_t minCapacity);
+
+	std::vector<std::uint8_t> buffer;
+	std::size_t head = 0;
+	std::size_t length = 0;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_RECEIVEBUFFER_H_ */
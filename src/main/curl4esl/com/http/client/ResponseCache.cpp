@@ -0,0 +1,440 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/ResponseCache.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+
+#include <esl/com/http/client/exception/NetworkError.h>
+#include <esl/system/Stacktrace.h>
+#include <esl/utility/String.h>
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <thread>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+struct CacheControl {
+	bool noStore = false;
+	bool isPrivate = false;
+	bool noCache = false;
+	long maxAge = -1;
+	long sMaxAge = -1;
+};
+
+bool equalsIgnoreCase(const std::string& str1, const char* str2) {
+	return HeaderStore::equalsIgnoreCase(str1.data(), str1.size(), str2, std::char_traits<char>::length(str2));
+}
+
+bool findRequestHeader(const PreparedRequest& request, const PreparedRequest::Headers* headers, const std::string& key, std::string& value) {
+	if(headers) {
+		for(const auto& header : *headers) {
+			if(HeaderStore::equalsIgnoreCase(header.first.data(), header.first.size(), key.data(), key.size())) {
+				value = header.second;
+				return true;
+			}
+		}
+	}
+	return request.findHeader(key, value);
+}
+
+bool matchesVary(const ResponseCache::Entry& entry, const PreparedRequest& request, const PreparedRequest::Headers* headers) {
+	std::string value;
+	for(const auto& vary : entry.vary) {
+		if(!findRequestHeader(request, headers, vary.first, value)) {
+			value.clear();
+		}
+		if(value != vary.second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* parses a non negative decimal number, returns -1 if it is invalid */
+long toNumber(const std::string& value) {
+	long seconds = 0;
+	for(char c : value) {
+		if(c < '0' || c > '9') {
+			return -1;
+		}
+		if(seconds < 1000000000L) {
+			seconds = seconds * 10 + (c - '0');
+		}
+	}
+	return value.empty() ? -1 : seconds;
+}
+
+CacheControl parseCacheControl(const std::string& value) {
+	CacheControl cacheControl;
+
+	for(const auto& part : esl::utility::String::split(value, ',')) {
+		std::string directive = esl::utility::String::toLower(esl::utility::String::trim(part));
+		if(directive == "no-store") {
+			cacheControl.noStore = true;
+		}
+		else if(directive == "private" || directive.compare(0, 8, "private=") == 0) {
+			cacheControl.isPrivate = true;
+		}
+		else if(directive == "no-cache" || directive.compare(0, 9, "no-cache=") == 0) {
+			cacheControl.noCache = true;
+		}
+		else if(directive.compare(0, 8, "max-age=") == 0) {
+			cacheControl.maxAge = toNumber(esl::utility::String::trim(directive.substr(8), '"'));
+		}
+		else if(directive.compare(0, 9, "s-maxage=") == 0) {
+			cacheControl.sMaxAge = toNumber(esl::utility::String::trim(directive.substr(9), '"'));
+		}
+	}
+
+	return cacheControl;
+}
+
+/* sets freshness and validators of 'entry' from the headers of its response */
+void updateFreshness(ResponseCache::Entry& entry) {
+	const std::map<std::string, std::string>& headers = entry.response.getHeaders();
+	CacheControl cacheControl;
+
+	const std::string* value = HeaderStore::find(headers, "Cache-Control");
+	if(value) {
+		cacheControl = parseCacheControl(*value);
+	}
+
+	/* a shared cache uses s-maxage in favour of max-age */
+	long freshness = cacheControl.sMaxAge >= 0 ? cacheControl.sMaxAge : (cacheControl.maxAge >= 0 ? cacheControl.maxAge : 0);
+
+	value = HeaderStore::find(headers, "Age");
+	if(value) {
+		long age = toNumber(esl::utility::String::trim(*value));
+		if(age > 0) {
+			freshness = age < freshness ? freshness - age : 0;
+		}
+	}
+
+	entry.expires = std::chrono::steady_clock::now() + std::chrono::seconds(freshness);
+	entry.noCache = cacheControl.noCache;
+
+	value = HeaderStore::find(headers, "ETag");
+	entry.etag = value ? *value : std::string();
+
+	value = HeaderStore::find(headers, "Last-Modified");
+	entry.lastModified = value ? *value : std::string();
+
+	entry.size = entry.key.size() + entry.body->size();
+	for(const auto& header : headers) {
+		entry.size += header.first.size() + header.second.size();
+	}
+}
+}  // anonymer namespace
+
+ResponseCache::Entry::Entry(std::string aKey, std::vector<std::pair<std::string, std::string>> aVary, esl::com::http::client::Response aResponse, std::shared_ptr<const std::string> aBody)
+: key(std::move(aKey)),
+  vary(std::move(aVary)),
+  response(std::move(aResponse)),
+  body(std::move(aBody))
+{ }
+
+bool ResponseCache::Entry::isFresh(std::chrono::steady_clock::time_point now) const noexcept {
+	return !noCache && now < expires;
+}
+
+ResponseCache::CaptureWriter::CaptureWriter(esl::io::Input aInput, std::shared_ptr<Capture> aCapture)
+: input(std::move(aInput)),
+  writer(input.getWriter()),
+  capture(std::move(aCapture))
+{ }
+
+std::size_t ResponseCache::CaptureWriter::write(const void* data, std::size_t size) {
+	std::size_t sizeWritten = writer.write(data, size);
+
+	if(sizeWritten == esl::io::Writer::npos) {
+		capture->incomplete = true;
+		return sizeWritten;
+	}
+
+	if(!capture->incomplete) {
+		if(capture->body.size() + sizeWritten > capture->maxSize) {
+			capture->incomplete = true;
+			std::string().swap(capture->body);
+		}
+		else {
+			capture->body.append(static_cast<const char*>(data), sizeWritten);
+		}
+	}
+
+	return sizeWritten;
+}
+
+std::size_t ResponseCache::CaptureWriter::getSizeWritable() const {
+	return writer.getSizeWritable();
+}
+
+ResponseCache::ResponseCache(const esl::com::http::client::CURLConnectionFactory::Settings& aSettings)
+: settings(aSettings)
+{ }
+
+bool ResponseCache::isEnabled() const noexcept {
+	return settings.cacheSize > 0;
+}
+
+bool ResponseCache::isCacheable(const PreparedRequest& request, const PreparedRequest::Headers* headers) {
+	if(request.getMethod() != "GET") {
+		return false;
+	}
+
+	/* conditional and partial requests are left to the caller, credentials of a single request must not be shared */
+	static const char* const bypassHeaders[] = { "Authorization", "Range", "If-Range", "If-Match", "If-None-Match", "If-Modified-Since", "If-Unmodified-Since" };
+	std::string value;
+	for(const char* key : bypassHeaders) {
+		if(findRequestHeader(request, headers, key, value)) {
+			return false;
+		}
+	}
+
+	if(findRequestHeader(request, headers, "Cache-Control", value) && parseCacheControl(value).noStore) {
+		return false;
+	}
+
+	return true;
+}
+
+bool ResponseCache::isRevalidationRequired(const PreparedRequest& request, const PreparedRequest::Headers* headers) {
+	std::string value;
+
+	if(findRequestHeader(request, headers, "Cache-Control", value)) {
+		CacheControl cacheControl = parseCacheControl(value);
+		if(cacheControl.noCache || cacheControl.maxAge == 0) {
+			return true;
+		}
+	}
+
+	return findRequestHeader(request, headers, "Pragma", value) && equalsIgnoreCase(esl::utility::String::trim(value), "no-cache");
+}
+
+std::shared_ptr<const ResponseCache::Entry> ResponseCache::find(const PreparedRequest& request, const PreparedRequest::Headers* headers) {
+	std::string key = getKey(request);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto iter = index.find(key);
+	if(iter == index.end()) {
+		return nullptr;
+	}
+
+	for(auto entryIter : iter->second) {
+		if(matchesVary(**entryIter, request, headers)) {
+			entries.splice(entries.begin(), entries, entryIter);
+			return *entryIter;
+		}
+	}
+
+	return nullptr;
+}
+
+void ResponseCache::store(const PreparedRequest& request, const PreparedRequest::Headers* headers, const esl::com::http::client::Response& response, Capture& capture) {
+	if(response.getStatusCode() != 200 || capture.incomplete) {
+		return;
+	}
+
+	const std::map<std::string, std::string>& responseHeaders = response.getHeaders();
+
+	/* createInput is called for the first data only, so if it has not been called the body must be empty */
+	const std::string* value = HeaderStore::find(responseHeaders, "Content-Length");
+	if(value) {
+		if(toNumber(esl::utility::String::trim(*value)) != static_cast<long>(capture.body.size())) {
+			return;
+		}
+	}
+	else if(!capture.teed) {
+		return;
+	}
+
+	value = HeaderStore::find(responseHeaders, "Cache-Control");
+	if(value) {
+		CacheControl cacheControl = parseCacheControl(*value);
+		if(cacheControl.noStore || cacheControl.isPrivate) {
+			return;
+		}
+	}
+
+	std::vector<std::pair<std::string, std::string>> vary;
+
+	value = HeaderStore::find(responseHeaders, "Vary");
+	if(value) {
+		for(const auto& part : esl::utility::String::split(*value, ',')) {
+			std::string name = esl::utility::String::toLower(esl::utility::String::trim(part));
+			if(name == "*") {
+				return;
+			}
+			if(name.empty()) {
+				continue;
+			}
+
+			std::string requestValue;
+			findRequestHeader(request, headers, name, requestValue);
+			vary.emplace_back(std::move(name), std::move(requestValue));
+		}
+	}
+
+	std::shared_ptr<Entry> entry = std::make_shared<Entry>(getKey(request), std::move(vary), response, std::make_shared<const std::string>(std::move(capture.body)));
+	updateFreshness(*entry);
+
+	/* a response that is neither fresh nor can be revalidated is of no use */
+	if(!entry->isFresh(std::chrono::steady_clock::now()) && entry->etag.empty() && entry->lastModified.empty()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	insert(std::move(entry));
+}
+
+std::shared_ptr<const ResponseCache::Entry> ResponseCache::refresh(const std::shared_ptr<const Entry>& entry, const esl::com::http::client::Response& notModified) {
+	std::map<std::string, std::string> headers = entry->response.getHeaders();
+
+	/* headers of a 304 response replace the stored ones, except those describing the body */
+	for(const auto& header : notModified.getHeaders()) {
+		if(equalsIgnoreCase(header.first, "Content-Length") || equalsIgnoreCase(header.first, "Content-Encoding") || equalsIgnoreCase(header.first, "Transfer-Encoding")) {
+			continue;
+		}
+
+		for(auto iter = headers.begin(); iter != headers.end();) {
+			if(HeaderStore::equalsIgnoreCase(iter->first.data(), iter->first.size(), header.first.data(), header.first.size())) {
+				iter = headers.erase(iter);
+			}
+			else {
+				++iter;
+			}
+		}
+		headers.insert(header);
+	}
+
+	std::shared_ptr<Entry> newEntry = std::make_shared<Entry>(entry->key, entry->vary,
+			esl::com::http::client::Response(entry->response.getStatusCode(), std::move(headers), entry->response.getContentType()),
+			entry->body);
+	updateFreshness(*newEntry);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	insert(newEntry);
+
+	return newEntry;
+}
+
+esl::com::http::client::Response ResponseCache::replay(const Entry& entry, const std::function<esl::io::Input (const esl::com::http::client::Response&)>& createInput) {
+	esl::com::http::client::Response response(entry.response);
+
+	/* like a received response, createInput is called only if there is a body */
+	if(entry.body->empty()) {
+		return response;
+	}
+
+	esl::io::Input input = createInput(response);
+
+	WriterStall writerStall(std::chrono::milliseconds(settings.writerStallTimeout));
+	const char* data = entry.body->data();
+	std::size_t sizeRemaining = entry.body->size();
+	while(input && sizeRemaining > 0) {
+		std::size_t sizeWritten = input.getWriter().write(data, sizeRemaining);
+
+		if(sizeWritten == esl::io::Writer::npos) {
+			break;
+		}
+
+		if(sizeWritten == 0) {
+			if(!writerStall.stall()) {
+				std::string str = "Fehlercode=" + std::to_string(CURLE_WRITE_ERROR) + " (" + curl_easy_strerror(CURLE_WRITE_ERROR) + ") writer has not taken the rest of the cached response body";
+				throw esl::system::Stacktrace::add(esl::com::http::client::exception::NetworkError(static_cast<int>(CURLE_WRITE_ERROR), str));
+			}
+			std::this_thread::sleep_for(writerStall.getBackoff());
+			continue;
+		}
+
+		writerStall.reset();
+		data += sizeWritten;
+		sizeRemaining -= sizeWritten;
+	}
+
+	return response;
+}
+
+std::size_t ResponseCache::getMaxEntrySize() const noexcept {
+	/* a single large response must not displace the whole cache */
+	return settings.cacheSize / 4;
+}
+
+std::string ResponseCache::getKey(const PreparedRequest& request) {
+	return request.getMethod() + " " + request.getUrl();
+}
+
+void ResponseCache::insert(std::shared_ptr<const Entry> entry) {
+	std::vector<std::list<std::shared_ptr<const Entry>>::iterator>& variants = index[entry->key];
+
+	for(auto iter = variants.begin(); iter != variants.end(); ++iter) {
+		if((**iter)->vary == entry->vary) {
+			size -= (**iter)->size;
+			entries.erase(*iter);
+			variants.erase(iter);
+			break;
+		}
+	}
+
+	if(entry->size > settings.cacheSize) {
+		if(variants.empty()) {
+			index.erase(entry->key);
+		}
+		return;
+	}
+
+	size += entry->size;
+	entries.push_front(std::move(entry));
+	variants.insert(variants.begin(), entries.begin());
+
+	evict();
+}
+
+void ResponseCache::evict() {
+	while(size > settings.cacheSize && !entries.empty()) {
+		auto entryIter = std::prev(entries.end());
+		auto iter = index.find((*entryIter)->key);
+
+		std::vector<std::list<std::shared_ptr<const Entry>>::iterator>& variants = iter->second;
+		variants.erase(std::find(variants.begin(), variants.end(), entryIter));
+		if(variants.empty()) {
+			index.erase(iter);
+		}
+
+		size -= (*entryIter)->size;
+		entries.erase(entryIter);
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,152 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_RESPONSECACHE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_RESPONSECACHE_H_
+
+#include <esl/com/http/client/CURLConnectionFactory.h>
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+#include <esl/io/Writer.h>
+
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/WriterStall.h>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Size bounded LRU cache of GET responses following RFC 9111. It is shared by all
+ * connections of a factory, so it behaves like a shared cache: responses marked
+ * 'private' or 'no-store' and requests with Authorization are not stored.
+ * Stale entries are revalidated with If-None-Match and If-Modified-Since. */
+class ResponseCache {
+public:
+	/* immutable, so it can be replayed without holding the lock */
+	struct Entry {
+		Entry(std::string key, std::vector<std::pair<std::string, std::string>> vary, esl::com::http::client::Response response, std::shared_ptr<const std::string> body);
+
+		std::string key;
+		/* lower case names of the Vary header and the values of the request that has been stored */
+		std::vector<std::pair<std::string, std::string>> vary;
+
+		esl::com::http::client::Response response;
+		std::shared_ptr<const std::string> body;
+
+		std::string etag;
+		std::string lastModified;
+
+		std::chrono::steady_clock::time_point expires;
+		/* 'no-cache': the entry must be revalidated before each use */
+		bool noCache = false;
+		std::size_t size = 0;
+
+		bool isFresh(std::chrono::steady_clock::time_point now) const noexcept;
+	};
+
+	/* response body that is received while it is passed to the input of the caller */
+	struct Capture {
+		std::string body;
+		std::size_t maxSize = 0;
+		/* createInput has been called and the body has been teed */
+		bool teed = false;
+		/* body is larger than maxSize or the writer has stopped receiving */
+		bool incomplete = false;
+	};
+
+	class CaptureWriter : public esl::io::Writer {
+	public:
+		CaptureWriter(esl::io::Input input, std::shared_ptr<Capture> capture);
+
+		std::size_t write(const void* data, std::size_t size) override;
+		std::size_t getSizeWritable() const override;
+
+	private:
+		esl::io::Input input;
+		esl::io::Writer& writer;
+		std::shared_ptr<Capture> capture;
+	};
+
+	ResponseCache(const esl::com::http::client::CURLConnectionFactory::Settings& settings);
+
+	bool isEnabled() const noexcept;
+
+	/* returns true if the response of this request may be taken from or stored in the cache */
+	static bool isCacheable(const PreparedRequest& request, const PreparedRequest::Headers* headers);
+
+	/* returns true if the request demands revalidation of a stored response ('no-cache') */
+	static bool isRevalidationRequired(const PreparedRequest& request, const PreparedRequest::Headers* headers);
+
+	/* returns the most recently stored variant matching URL and Vary headers of the request or nullptr */
+	std::shared_ptr<const Entry> find(const PreparedRequest& request, const PreparedRequest::Headers* headers);
+
+	/* stores the response if it is cacheable and its body has been captured completely */
+	void store(const PreparedRequest& request, const PreparedRequest::Headers* headers, const esl::com::http::client::Response& response, Capture& capture);
+
+	/* updates a stored entry with the headers of a '304 Not Modified' response and returns the updated entry */
+	std::shared_ptr<const Entry> refresh(const std::shared_ptr<const Entry>& entry, const esl::com::http::client::Response& notModified);
+
+	/* Passes the stored response to 'createInput' and writes the stored body to the input, like a fresh response.
+	 * A writer that does not take data for longer than setting 'writer-stall-timeout' causes a network error. */
+	esl::com::http::client::Response replay(const Entry& entry, const std::function<esl::io::Input (const esl::com::http::client::Response&)>& createInput);
+
+	/* maximum body size of a response that may be stored */
+	std::size_t getMaxEntrySize() const noexcept;
+
+private:
+	static std::string getKey(const PreparedRequest& request);
+
+	/* adds an entry or replaces the variant with the same Vary values, mutex must be locked */
+	void insert(std::shared_ptr<const Entry> entry);
+	/* removes the least recently used entries until the size is within the limit, mutex must be locked */
+	void evict();
+
+	const esl::com::http::client::CURLConnectionFactory::Settings& settings;
+
+	std::mutex mutex;
+	/* most recently used entry at front */
+	std::list<std::shared_ptr<const Entry>> entries;
+	/* variants stored for a key, e.g. with different Accept-Encoding, most recently stored variant first */
+	std::unordered_map<std::string, std::vector<std::list<std::shared_ptr<const Entry>>::iterator>> index;
+	std::size_t size = 0;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_RESPONSECACHE_H_ */
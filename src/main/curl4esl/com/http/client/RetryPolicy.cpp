@@ -0,0 +1,119 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/RetryPolicy.h>
+
+#include <algorithm>
+#include <random>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+constexpr std::int64_t windowSeconds = 10;
+
+std::int64_t getCurrentWindow() noexcept {
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count() / windowSeconds;
+}
+}  // anonymer namespace
+
+RetryPolicy::RetryPolicy(const esl::com::http::client::CURLConnectionFactory::Settings& aSettings)
+: settings(aSettings),
+  window(getCurrentWindow())
+{ }
+
+bool RetryPolicy::isEnabled() const noexcept {
+	return settings.retryMaxAttempts > 1;
+}
+
+bool RetryPolicy::mayRetry(std::size_t attempt) noexcept {
+	if(attempt >= settings.retryMaxAttempts) {
+		return false;
+	}
+
+	updateWindow();
+
+	std::uint64_t budget = requests.load(std::memory_order_relaxed) * settings.retryBudget / 100;
+	return retries.load(std::memory_order_relaxed) < std::max<std::uint64_t>(budget, settings.retryBudgetMin);
+}
+
+bool RetryPolicy::isRetryable(CURLcode rc, bool idempotent) const noexcept {
+	if(std::find(settings.retryCurlCodes.begin(), settings.retryCurlCodes.end(), static_cast<int>(rc)) == settings.retryCurlCodes.end()) {
+		return false;
+	}
+
+	/* the request has not been sent if there was no connection */
+	return idempotent || rc == CURLE_COULDNT_RESOLVE_HOST || rc == CURLE_COULDNT_RESOLVE_PROXY || rc == CURLE_COULDNT_CONNECT;
+}
+
+bool RetryPolicy::isRetryable(long statusCode, bool idempotent) const noexcept {
+	return idempotent && std::find(settings.retryStatusCodes.begin(), settings.retryStatusCodes.end(), statusCode) != settings.retryStatusCodes.end();
+}
+
+void RetryPolicy::recordRequest() noexcept {
+	updateWindow();
+	requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RetryPolicy::recordRetry() noexcept {
+	updateWindow();
+	retries.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::chrono::milliseconds RetryPolicy::getBackoff(std::size_t attempt) const {
+	long backoff = settings.retryMaxBackoff;
+	if(attempt <= 31 && settings.retryBaseBackoff <= (settings.retryMaxBackoff >> (attempt - 1))) {
+		backoff = settings.retryBaseBackoff << (attempt - 1);
+	}
+
+	if(backoff <= 0) {
+		return std::chrono::milliseconds(0);
+	}
+
+	static thread_local std::minstd_rand random(std::random_device{}());
+	std::uniform_int_distribution<long> distribution(0, backoff);
+	return std::chrono::milliseconds(distribution(random));
+}
+
+bool RetryPolicy::isIdempotent(const std::string& method) noexcept {
+	return method == "GET" || method == "HEAD" || method == "OPTIONS" || method == "TRACE" || method == "PUT" || method == "DELETE";
+}
+
+void RetryPolicy::updateWindow() noexcept {
+	std::int64_t currentWindow = getCurrentWindow();
+	std::int64_t lastWindow = window.load(std::memory_order_relaxed);
+
+	/* only one thread resets the counters, counts of a concurrent send might get lost but the budget is an estimate anyway */
+	if(lastWindow != currentWindow && window.compare_exchange_strong(lastWindow, currentWindow, std::memory_order_relaxed)) {
+		requests.store(0, std::memory_order_relaxed);
+		retries.store(0, std::memory_order_relaxed);
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
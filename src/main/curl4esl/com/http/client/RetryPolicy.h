@@ -0,0 +1,86 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_RETRYPOLICY_H_
+#define CURL4ESL_COM_HTTP_CLIENT_RETRYPOLICY_H_
+
+#include <esl/com/http/client/CURLConnectionFactory.h>
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Decides if a failed attempt of a send is repeated and how long to wait before.
+ * Retries of all sends of a factory are limited by a budget: within a window of
+ * 10 seconds at most 'retryBudget' percent of the requests may be retried, but
+ * at least 'retryBudgetMin' retries are always allowed. This keeps an overloaded
+ * server from being hit by a retry storm. */
+class RetryPolicy {
+public:
+	RetryPolicy(const esl::com::http::client::CURLConnectionFactory::Settings& settings);
+
+	bool isEnabled() const noexcept;
+
+	/* returns true if another attempt may follow 'attempt' (starting with 1) and the budget is not exhausted */
+	bool mayRetry(std::size_t attempt) noexcept;
+
+	/* 'idempotent' must be false if the request might have been processed by the server */
+	bool isRetryable(CURLcode rc, bool idempotent) const noexcept;
+	/* a response has been processed by the server, so only idempotent requests are retried */
+	bool isRetryable(long statusCode, bool idempotent) const noexcept;
+
+	void recordRequest() noexcept;
+	void recordRetry() noexcept;
+
+	/* "full jitter": random duration between 0 and the exponential backoff of 'attempt' */
+	std::chrono::milliseconds getBackoff(std::size_t attempt) const;
+
+	static bool isIdempotent(const std::string& method) noexcept;
+
+private:
+	/* starts a new window if the current one is over */
+	void updateWindow() noexcept;
+
+	const esl::com::http::client::CURLConnectionFactory::Settings& settings;
+
+	std::atomic<std::int64_t> window { 0 };
+	std::atomic<std::uint64_t> requests { 0 };
+	std::atomic<std::uint64_t> retries { 0 };
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_RETRYPOLICY_H_ */
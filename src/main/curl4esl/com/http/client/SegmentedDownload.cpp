@@ -0,0 +1,380 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/SegmentedDownload.h>
+#include <curl4esl/com/http/client/AsyncSend.h>
+#include <curl4esl/com/http/client/Body.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+
+#include <esl/system/Stacktrace.h>
+
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* parses the complete length of "bytes <first>-<last>/<length>" or "bytes *\/<length>" and the first byte position */
+bool parseContentRange(const std::string& value, std::uint64_t& first, std::uint64_t& length) {
+	std::size_t pos = value.find("bytes ");
+	std::size_t separator = value.find('/');
+	if(pos == std::string::npos || separator == std::string::npos || separator + 1 >= value.size()) {
+		return false;
+	}
+
+	first = 0;
+	for(std::size_t i = pos + 6; i < separator && value[i] >= '0' && value[i] <= '9'; ++i) {
+		first = first * 10 + static_cast<std::uint64_t>(value[i] - '0');
+	}
+
+	length = 0;
+	for(std::size_t i = separator + 1; i < value.size(); ++i) {
+		if(value[i] < '0' || value[i] > '9') {
+			return false;
+		}
+		length = length * 10 + static_cast<std::uint64_t>(value[i] - '0');
+	}
+
+	return true;
+}
+
+std::string getHeader(const esl::com::http::client::Response& response, const char* key) {
+	const std::string* value = HeaderStore::find(response.getHeaders(), key);
+	return value ? *value : std::string();
+}
+}  // anonymer namespace
+
+SegmentedDownload::FileWriter::FileWriter(SegmentedDownload& aDownload, Segment& aSegment)
+: download(aDownload),
+  segment(aSegment)
+{ }
+
+std::size_t SegmentedDownload::FileWriter::write(const void* data, std::size_t size) {
+	std::uint64_t offset = segment.begin + segment.written;
+
+	/* the server must not send more than the requested range */
+	if(size > segment.end - offset) {
+		return esl::io::Writer::npos;
+	}
+
+#ifndef _WIN32
+	if(download.map) {
+		std::memcpy(download.map + offset, data, size);
+	}
+	else {
+		const std::uint8_t* ptr = static_cast<const std::uint8_t*>(data);
+		std::size_t remaining = size;
+		while(remaining > 0) {
+			ssize_t rc = ::pwrite(download.fd, ptr, remaining, static_cast<off_t>(offset + (size - remaining)));
+			if(rc < 0) {
+				if(errno == EINTR) {
+					continue;
+				}
+		        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: writing to file \"" + download.path + "\" failed: " + std::strerror(errno)));
+			}
+			ptr += rc;
+			remaining -= static_cast<std::size_t>(rc);
+		}
+	}
+#endif
+
+	segment.written += size;
+	return size;
+}
+
+std::size_t SegmentedDownload::FileWriter::getSizeWritable() const {
+	return static_cast<std::size_t>(std::min<std::uint64_t>(segment.end - segment.begin - segment.written, std::numeric_limits<std::size_t>::max()));
+}
+
+SegmentedDownload::SegmentedDownload(std::shared_ptr<HandlePool> aHandlePool, std::shared_ptr<MultiEngine> aMultiEngine, std::shared_ptr<const PreparedRequest> aRequest, const std::string& aPath)
+: handlePool(std::move(aHandlePool)),
+  multiEngine(std::move(aMultiEngine)),
+  request(std::move(aRequest)),
+  path(aPath)
+{
+#ifdef _WIN32
+    throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: segmented download is not supported on this platform"));
+#else
+	fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(fd < 0) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: cannot open file \"" + path + "\": " + std::strerror(errno)));
+	}
+#endif
+}
+
+SegmentedDownload::~SegmentedDownload() {
+#ifndef _WIN32
+	if(map) {
+		::munmap(map, static_cast<std::size_t>(size));
+	}
+	if(fd >= 0) {
+		::close(fd);
+	}
+#endif
+}
+
+SegmentedDownload::Result SegmentedDownload::execute(std::size_t segmentCount) {
+	const esl::com::http::client::CURLConnectionFactory::Settings& settings = handlePool->getSettings();
+	if(segmentCount == 0) {
+		segmentCount = settings.downloadSegments;
+	}
+
+	Segment probeSegment;
+	esl::com::http::client::Response response = probe(probeSegment);
+
+	Result result;
+	result.etag = getHeader(response, "ETag");
+
+	/* ranges are not supported, the probe has received the whole resource */
+	if(response.getStatusCode() == 200) {
+		std::string contentLength = getHeader(response, "Content-Length");
+		if(!contentLength.empty() && contentLength != std::to_string(probeSegment.written)) {
+	        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: download of \"" + request->getUrl() + "\" is incomplete, received " + std::to_string(probeSegment.written) + " of " + contentLength + " bytes"));
+		}
+		result.size = probeSegment.written;
+		result.segments = 1;
+		return result;
+	}
+
+	std::uint64_t first = 0;
+	bool hasContentRange = parseContentRange(getHeader(response, "Content-Range"), first, size);
+
+	/* range 0-0 is not satisfiable for an empty resource */
+	if(response.getStatusCode() == 416 && hasContentRange && size == 0) {
+		result.segments = 1;
+		return result;
+	}
+
+	if(response.getStatusCode() != 206 || !hasContentRange || first != 0) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: download of \"" + request->getUrl() + "\" failed with status code " + std::to_string(response.getStatusCode())));
+	}
+
+	etag = result.etag;
+	if(!etag.empty() && etag.compare(0, 2, "W/") != 0) {
+		ifRange = etag;
+	}
+	else {
+		ifRange = getHeader(response, "Last-Modified");
+	}
+
+	allocate(size);
+
+	/* the probe has written the first byte already */
+	std::uint64_t offset = probeSegment.written;
+	std::uint64_t length = size - offset;
+	std::uint64_t minSegmentSize = std::max<std::uint64_t>(settings.downloadMinSegmentSize, 1);
+	std::uint64_t count = std::min<std::uint64_t>(segmentCount, (length + minSegmentSize - 1) / minSegmentSize);
+
+	/* not resized while the segments are running, they are referenced by their transfers */
+	segments.resize(static_cast<std::size_t>(count));
+	for(std::size_t i = 0; i < segments.size(); ++i) {
+		segments[i].begin = offset + length * i / count;
+		segments[i].end = offset + length * (i + 1) / count;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		remaining = segments.size();
+	}
+	for(auto& segment : segments) {
+		try {
+			start(segment, std::chrono::milliseconds(0));
+		}
+		catch(...) {
+			finish(segment, std::current_exception());
+		}
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [this] {
+			return remaining == 0;
+		});
+	}
+
+	for(auto& segment : segments) {
+		if(segment.exceptionPtr) {
+			std::rethrow_exception(segment.exceptionPtr);
+		}
+	}
+
+	result.size = size;
+	result.segments = segments.size();
+	return result;
+}
+
+esl::com::http::client::Response SegmentedDownload::probe(Segment& segment) {
+	segment.headers.emplace_back("Range", "bytes=0-0");
+	/* ranges refer to the encoded representation, so the body must not be encoded */
+	segment.headers.emplace_back("Accept-Encoding", "identity");
+
+	std::promise<esl::com::http::client::Response> promise;
+	std::future<esl::com::http::client::Response> future = promise.get_future();
+
+	Segment* segmentPtr = &segment;
+	std::unique_ptr<AsyncSend> transfer(new AsyncSend(handlePool->acquire(), request, Body(),
+			[this, segmentPtr](const esl::com::http::client::Response& response) {
+		if(response.getStatusCode() == 206) {
+			segmentPtr->end = 1;
+		}
+		else if(response.getStatusCode() == 200) {
+			segmentPtr->end = std::numeric_limits<std::uint64_t>::max();
+		}
+		else {
+			return esl::io::Input();
+		}
+		return esl::io::Input(std::unique_ptr<esl::io::Writer>(new FileWriter(*this, *segmentPtr)));
+	},
+			[&promise](const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr) {
+		if(response) {
+			promise.set_value(*response);
+		}
+		else {
+			promise.set_exception(exceptionPtr);
+		}
+	}, &segment.headers));
+	multiEngine->add(std::move(transfer));
+
+	return future.get();
+}
+
+void SegmentedDownload::allocate(std::uint64_t aSize) {
+#ifndef _WIN32
+	if(aSize == 0) {
+		return;
+	}
+	if(aSize > std::numeric_limits<std::size_t>::max()) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: file \"" + path + "\" is too large to be mapped"));
+	}
+
+	/* reserve the blocks now, so the download does not fail with a full disk at the end */
+	if(::posix_fallocate(fd, 0, static_cast<off_t>(aSize)) != 0 && ::ftruncate(fd, static_cast<off_t>(aSize)) != 0) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: cannot allocate file \"" + path + "\": " + std::strerror(errno)));
+	}
+
+	void* ptr = ::mmap(nullptr, static_cast<std::size_t>(aSize), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(ptr == MAP_FAILED) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: cannot map file \"" + path + "\": " + std::strerror(errno)));
+	}
+	map = static_cast<std::uint8_t*>(ptr);
+#endif
+}
+
+void SegmentedDownload::start(Segment& segment, std::chrono::milliseconds delay) {
+	segment.headers.clear();
+	segment.headers.emplace_back("Range", "bytes=" + std::to_string(segment.begin + segment.written) + "-" + std::to_string(segment.end - 1));
+	if(!ifRange.empty()) {
+		segment.headers.emplace_back("If-Range", ifRange);
+	}
+	segment.headers.emplace_back("Accept-Encoding", "identity");
+
+	Segment* segmentPtr = &segment;
+	std::unique_ptr<AsyncSend> transfer(new AsyncSend(handlePool->acquire(), request, Body(),
+			[this, segmentPtr](const esl::com::http::client::Response& response) {
+		return createInput(*segmentPtr, response);
+	},
+			[this, segmentPtr](const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr) {
+		done(*segmentPtr, response, exceptionPtr);
+	}, &segment.headers));
+	multiEngine->add(std::move(transfer), delay);
+}
+
+esl::io::Input SegmentedDownload::createInput(Segment& segment, const esl::com::http::client::Response& response) {
+	/* a full response to If-Range or another ETag means that the resource has been changed meanwhile */
+	if(response.getStatusCode() == 200 || (!etag.empty() && getHeader(response, "ETag") != etag)) {
+		segment.fatal = true;
+		return esl::io::Input();
+	}
+
+	std::uint64_t first = 0;
+	std::uint64_t length = 0;
+	if(response.getStatusCode() != 206 || !parseContentRange(getHeader(response, "Content-Range"), first, length)) {
+		return esl::io::Input();
+	}
+	if(length != size) {
+		segment.fatal = true;
+		return esl::io::Input();
+	}
+	if(first != segment.begin + segment.written) {
+		return esl::io::Input();
+	}
+
+	return esl::io::Input(std::unique_ptr<esl::io::Writer>(new FileWriter(*this, segment)));
+}
+
+void SegmentedDownload::done(Segment& segment, const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr) {
+	if(response && segment.begin + segment.written == segment.end) {
+		finish(segment, nullptr);
+		return;
+	}
+
+	if(segment.fatal) {
+		exceptionPtr = std::make_exception_ptr(esl::system::Stacktrace::add(std::runtime_error("curl4esl: \"" + request->getUrl() + "\" has been changed during download")));
+	}
+	else if(segment.attempts + 1 < handlePool->getSettings().downloadSegmentAttempts) {
+		/* resume at the current offset */
+		++segment.attempts;
+		try {
+			start(segment, handlePool->getRetryPolicy().getBackoff(segment.attempts));
+			return;
+		}
+		catch(...) {
+			exceptionPtr = std::current_exception();
+		}
+	}
+
+	if(!exceptionPtr) {
+		exceptionPtr = std::make_exception_ptr(esl::system::Stacktrace::add(std::runtime_error("curl4esl: download of \"" + request->getUrl() + "\" is incomplete, segment "
+				+ std::to_string(segment.begin) + "-" + std::to_string(segment.end - 1) + " failed" + (response ? " with status code " + std::to_string(response->getStatusCode()) : std::string()))));
+	}
+	finish(segment, exceptionPtr);
+}
+
+void SegmentedDownload::finish(Segment& segment, std::exception_ptr exceptionPtr) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	segment.exceptionPtr = exceptionPtr;
+	if(--remaining == 0) {
+		/* notify while locked, the waiting thread may return immediately afterwards */
+		condition.notify_all();
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
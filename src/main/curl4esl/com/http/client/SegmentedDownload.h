@@ -0,0 +1,136 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_SEGMENTEDDOWNLOAD_H_
+#define CURL4ESL_COM_HTTP_CLIENT_SEGMENTEDDOWNLOAD_H_
+
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+#include <esl/io/Writer.h>
+
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/MultiEngine.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Downloads a resource into a file with several range requests at the same time,
+ * each on its own pooled handle driven by the event loop. A probe for the first
+ * byte returns size and validators. The file is preallocated and memory mapped,
+ * so every segment writes its data directly at its offset. Failed segments are
+ * resumed at their current offset. If the server does not support ranges, the
+ * response of the probe is written to the file as a single segment.
+ * POSIX only. */
+class SegmentedDownload {
+public:
+	struct Result {
+		std::uint64_t size = 0;
+		std::string etag;
+		/* 1 if the server does not support range requests */
+		std::size_t segments = 0;
+	};
+
+	SegmentedDownload(std::shared_ptr<HandlePool> handlePool, std::shared_ptr<MultiEngine> multiEngine, std::shared_ptr<const PreparedRequest> request, const std::string& path);
+	SegmentedDownload(const SegmentedDownload&) = delete;
+	~SegmentedDownload();
+
+	SegmentedDownload& operator=(const SegmentedDownload&) = delete;
+
+	/* blocks until all segments are done, 0 uses setting 'download-segments' */
+	Result execute(std::size_t segmentCount);
+
+private:
+	struct Segment {
+		std::uint64_t begin = 0;
+		/* exclusive */
+		std::uint64_t end = 0;
+		std::uint64_t written = 0;
+		std::size_t attempts = 0;
+		PreparedRequest::Headers headers;
+		/* the resource has changed, so a retry is useless */
+		bool fatal = false;
+		std::exception_ptr exceptionPtr;
+	};
+
+	/* writes sequentially with pwrite if ranges are not supported, otherwise into the mapped file at the offset of a segment */
+	class FileWriter : public esl::io::Writer {
+	public:
+		FileWriter(SegmentedDownload& download, Segment& segment);
+
+		std::size_t write(const void* data, std::size_t size) override;
+		std::size_t getSizeWritable() const override;
+
+	private:
+		SegmentedDownload& download;
+		Segment& segment;
+	};
+
+	esl::com::http::client::Response probe(Segment& segment);
+	void allocate(std::uint64_t size);
+
+	void start(Segment& segment, std::chrono::milliseconds delay);
+	esl::io::Input createInput(Segment& segment, const esl::com::http::client::Response& response);
+	void done(Segment& segment, const esl::com::http::client::Response* response, std::exception_ptr exceptionPtr);
+	/* called if a segment will not be started again */
+	void finish(Segment& segment, std::exception_ptr exceptionPtr);
+
+	std::shared_ptr<HandlePool> handlePool;
+	std::shared_ptr<MultiEngine> multiEngine;
+	std::shared_ptr<const PreparedRequest> request;
+	std::string path;
+
+	int fd = -1;
+	std::uint8_t* map = nullptr;
+	std::uint64_t size = 0;
+
+	std::string etag;
+	/* ETag if it is strong, otherwise Last-Modified */
+	std::string ifRange;
+
+	std::vector<Segment> segments;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::size_t remaining = 0;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_SEGMENTEDDOWNLOAD_H_ */
@@ -26,14 +26,17 @@ SOFTWARE.
 #include <esl/Logger.h>
 #include <esl/io/Reader.h>
 #include <esl/io/Writer.h>
-#include <esl/utility/String.h>
 
 #include <esl/com/http/client/exception/NetworkError.h>
 #include <esl/system/Stacktrace.h>
 #include <esl/utility/MIME.h>
 
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <sstream>
+#include <thread>
+#include <utility>
 
 namespace curl4esl {
 inline namespace v1_6 {
@@ -44,108 +47,262 @@ namespace client {
 namespace {
 esl::Logger logger("curl4esl::com::http::client::Send");
 
-esl::utility::MIME findContentType(const std::map<std::string, std::string>& headers) {
-	for(const auto& entry : headers) {
-		if(entry.first == "Content-Type") {
-			// Value could be "text/html; charset=UTF-8", so we have to split for ';' character and we take first element
-			std::vector<std::string> contentTypes = esl::utility::String::split(esl::utility::String::trim(entry.second), ';');
-			if(!contentTypes.empty()) {
-				return esl::utility::MIME(esl::utility::String::trim(contentTypes.front()));
-			}
-			break;
-		}
+bool isWhitespace(char c) noexcept {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void trim(const char*& begin, const char*& end) noexcept {
+	while(begin < end && isWhitespace(*begin)) {
+		++begin;
+	}
+	while(end > begin && isWhitespace(*(end - 1))) {
+		--end;
 	}
-	return esl::utility::MIME();
+}
+
+esl::utility::MIME findContentType(const HeaderStore& headers) {
+	const std::string* value = headers.find("Content-Type", 12);
+	if(value == nullptr) {
+		return esl::utility::MIME();
+	}
+
+	// Value could be "text/html; charset=UTF-8", so we take the part in front of the first ';' character
+	const char* begin = value->data();
+	const char* end = begin + value->size();
+	const char* separator = static_cast<const char*>(std::memchr(begin, ';', value->size()));
+	if(separator) {
+		end = separator;
+	}
+	trim(begin, end);
+
+	if(begin == end) {
+		return esl::utility::MIME();
+	}
+	return esl::utility::MIME(std::string(begin, end));
+}
+
+bool isIdentityEncoding(const std::string& value) {
+	const char* begin = value.data();
+	const char* end = begin + value.size();
+	trim(begin, end);
+
+	return begin == end || HeaderStore::equalsIgnoreCase(begin, static_cast<std::size_t>(end - begin), "identity", 8);
 }
 }  // anonymer namespace
 
-Send::Send(CURL* curl, const esl::com::http::client::Request& request, const std::string& requestUrl, esl::io::Output& output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput)
-: Send(curl, request, requestUrl, output, esl::io::Input(), createInput)
+constexpr long Send::fileUploadBufferSize;
+constexpr long Send::defaultUploadBufferSize;
+
+Send::Send(HandlePool::Handle& handle, const PreparedRequest& request, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers)
+: Send(handle, request, std::move(body), esl::io::Input(), createInput, headers)
 { }
 
-Send::Send(CURL* curl, const esl::com::http::client::Request& request, const std::string& requestUrl, esl::io::Output& output, esl::io::Input input)
-: Send(curl, request, requestUrl, output, std::move(input), nullptr)
+Send::Send(HandlePool::Handle& handle, const PreparedRequest& request, Body body, esl::io::Input input, const PreparedRequest::Headers* headers)
+: Send(handle, request, std::move(body), std::move(input), nullptr, headers)
 { }
 
-Send::Send(CURL* aCurl, const esl::com::http::client::Request& request, const std::string& requestUrl, esl::io::Output& aOutput, esl::io::Input aInput, std::function<esl::io::Input (const esl::com::http::client::Response&)> aCreateInput)
-: curl(aCurl),
-  firstWriteData(aCreateInput),
+Send::Send(HandlePool::Handle& handle, const PreparedRequest& request, Body aBody, esl::io::Input aInput, std::function<esl::io::Input (const esl::com::http::client::Response&)> aCreateInput, const PreparedRequest::Headers* headers)
+: curl(handle.curl),
+  requestHeaders(handle.requestHeaders),
   input(std::move(aInput)),
   createInput(aCreateInput),
-  output(aOutput)
+  body(std::move(aBody)),
+  responseHeaders(handle.responseHeaders),
+  receiveBuffer(handle.receiveBuffer),
+  maxReceiveBuffer(handle.pool->getSettings().maxReceiveBuffer),
+  writerStallTimeout(handle.pool->getSettings().writerStallTimeout),
+  writerStall(writerStallTimeout),
+  pipelineDepth(handle.pool->getSettings().pipelineDepth),
+  pipelineBuffers(handle.pipelineBuffers),
+  contentDecoding(handle.pool->getSettings().hasAcceptEncoding),
+  metrics(handle.pool->getMetrics()),
+  idempotent(RetryPolicy::isIdempotent(request.getMethod())),
+  resolveList(handle.pool->getDnsCache().getResolveList())
 {
+	requestHeaders.clear();
+	responseHeaders.clear();
+	receiveBuffer.clear();
+
 	/* ******* *
 	* set URL *
 	* ******* */
 
-	curl_easy_setopt(curl, CURLOPT_URL, requestUrl.c_str());
+	curl_easy_setopt(curl, CURLOPT_URL, request.getUrl().c_str());
+
+	/* addresses resolved in the background, a list of a previous send on this handle is reset if there is none */
+	curl_easy_setopt(curl, CURLOPT_RESOLVE, resolveList ? resolveList->get() : nullptr);
 
 	/* ******************* *
 	* create POST-Options *
 	* ******************* */
 
-	if(output) {
-		/** set read callback function */
-		curl_easy_setopt(curl, CURLOPT_READFUNCTION, readDataCallback);
+	/* The callbacks are installed on every handle, so their data must not point to a previous send
+	 * on a reused handle, even if the body of this send does not use them. */
+	curl_easy_setopt(curl, CURLOPT_READDATA, this);
+	curl_easy_setopt(curl, CURLOPT_SEEKDATA, this);
+
+	setUploadBufferSize(handle, body);
 
-		/** set data object to pass to callback function */
-		curl_easy_setopt(curl, CURLOPT_READDATA, this);
+	switch(body.getType()) {
+	case Body::Type::output:
+		curl_easy_setopt(curl, CURLOPT_POST, 1L);
 
-		curl_easy_setopt(curl, CURLOPT_POST, 1);
+		/* handle might be reused, so reset a buffer of a previous request to use the read callback */
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
 
-		if(output.getReader().hasSize()) {
-			long dataSize = static_cast<long>(output.getReader().getSize());
-			curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, dataSize);
+		if(body.getOutput().getReader().hasSize()) {
+			curl_off_t dataSize = static_cast<curl_off_t>(body.getOutput().getReader().getSize());
+			curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, dataSize);
 			/** set data size */
 			//curl_easy_setopt(curl, CURLOPT_INFILESIZE, dataSize);
 		}
 		else {
+			/* handle might be reused, so reset a size of a previous request */
+			curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(-1));
 			addRequestHeader("Transfer-Encoding", "chunked");
 		}
-	}
-	else {
+		break;
+
+	case Body::Type::buffer:
+		/* libcurl sends directly from the buffer, CURLOPT_COPYPOSTFIELDS is not used to avoid a copy */
+		curl_easy_setopt(curl, CURLOPT_POST, 1L);
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.getSize()));
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.getData());
+		break;
+
+	case Body::Type::file:
+		curl_easy_setopt(curl, CURLOPT_POST, 1L);
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+		/* size is known, so the body is not chunked */
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.getFileSize()));
+		break;
+
+	default:
 		// No data to send
-		curl_easy_setopt(curl, CURLOPT_POST, 0L);
+		/* Resets POST and a buffer of a previous request on a reused handle.
+		 * CURLOPT_POSTFIELDS must not be reset here, setting it switches to POST again. */
+		curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
 		/** set data size */
 		//curl_easy_setopt(curl, CURLOPT_INFILESIZE, 0L);
+		break;
 	}
 
 	/* ******************* *
 	 * create HTTP headers *
 	 * ******************* */
 
-	/* add content-type header */
-	if(request.getContentType()) {
-		addRequestHeader("Content-Type", request.getContentType().toString());
+	if(headers) {
+		for(const auto& v : *headers) {
+			addRequestHeader(v.first, v.second);
+		}
 	}
 
-	/* add other headers */
-	for(const auto& v : request.getHeaders()) {
-		addRequestHeader(v.first, v.second);
+	if(requestHeaders.getHead()) {
+		/* link the headers of the prepared request behind the headers of this send, they are unlinked by the destructor */
+		requestHeaders.getTail()->next = request.getHeaders();
+		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, requestHeaders.getHead());
+	}
+	else {
+		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request.getHeaders());
 	}
 
-	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, requestHeaders);
-
-	curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, request.getMethod().toString().c_str());
+	curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, request.getMethod().c_str());
 
-	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, writeHeaderCallback);
 	curl_easy_setopt(curl, CURLOPT_HEADERDATA, this);
-
-	/* check if this handler accepts data. If not, then we don't need to install writeDataCallback */
-
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeDataCallback);
 	curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+
+	/* progress callback is used to resume a paused transfer */
+	if(maxReceiveBuffer > 0 || body.getType() == Body::Type::output) {
+		curl_easy_setopt(curl, CURLOPT_XFERINFODATA, this);
+		curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+	}
+	else {
+		curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+	}
 }
 
 Send::~Send() {
-	if(requestHeaders) {
-		curl_slist_free_all(requestHeaders);
+	if(requestHeaders.getTail()) {
+		requestHeaders.getTail()->next = nullptr;
 	}
 }
 
+void Send::setUploadBufferSize(HandlePool::Handle& handle, const Body& body) {
+	long size = handle.pool->getSettings().uploadBufferSize > 0 ? handle.pool->getSettings().uploadBufferSize : 0;
+
+	/* each read callback becomes a single large pread instead of many small ones */
+	if(size == 0 && body.getType() == Body::Type::file) {
+		size = fileUploadBufferSize;
+	}
+
+	/* a large buffer of a previous file upload is not kept for other bodies */
+	if(handle.uploadBufferSize != size) {
+		curl_easy_setopt(handle.curl, CURLOPT_UPLOAD_BUFFERSIZE, size > 0 ? size : defaultUploadBufferSize);
+		handle.uploadBufferSize = size;
+	}
+}
+
+void Send::initHandle(CURL* curl) {
+	curl_easy_setopt(curl, CURLOPT_READFUNCTION, readDataCallback);
+	curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, seekDataCallback);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, writeHeaderCallback);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeDataCallback);
+	curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progressCallback);
+}
+
 esl::com::http::client::Response Send::execute() {
+	return complete(perform());
+}
+
+CURLcode Send::perform() {
+	blocking = true;
 	CURLcode rc = curl_easy_perform(curl);
 
+	/* the writer belongs to the calling thread, so waiting for it does not block other transfers */
+	if(rc == CURLE_OK) {
+		while(!drain()) {
+			std::this_thread::sleep_for(writerStall.getBackoff());
+		}
+	}
+
+	record(rc);
+	return rc;
+}
+
+bool Send::drain() {
+	try {
+		if(flushReceiveBuffer()) {
+			return true;
+		}
+		if(writerStall.stall()) {
+			return false;
+		}
+		abandonReceiveBuffer();
+	}
+	catch(...) {
+		exceptionPtr = std::current_exception();
+	}
+	return true;
+}
+
+void Send::record(CURLcode rc) noexcept {
+	if(metrics) {
+		metrics->record(curl, rc);
+	}
+}
+
+esl::com::http::client::Response Send::complete(CURLcode rc) {
+	/* data received so far is written before the result is evaluated, like without pipeline */
+	if(pipeline) {
+		std::unique_ptr<Pipeline> finishing = std::move(pipeline);
+		finishing->finish();
+	}
+
+	/* perform() and the engines have drained the receive buffer already, so the writer is still stalled if data is left */
+	if(rc == CURLE_OK && !exceptionPtr && !flushReceiveBuffer()) {
+		abandonReceiveBuffer();
+	}
+
 	if(exceptionPtr) {
 		std::rethrow_exception(exceptionPtr);
 	}
@@ -163,17 +320,37 @@ esl::com::http::client::Response Send::execute() {
 	return getResponse();
 }
 
-void Send::addRequestHeader(const std::string& key, const std::string& value) {
-	std::string header;
+void Send::setRetryPolicy(const RetryPolicy* aRetryPolicy) noexcept {
+	retryPolicy = aRetryPolicy;
+}
 
-	if(value.empty()) {
-		header = key + ";";
+bool Send::isRetryable(CURLcode rc) const {
+	if(retryPolicy == nullptr || exceptionPtr || dataWritten) {
+		return false;
 	}
-	else {
-		header = key + ": " + value;
+
+	if(rc == CURLE_OK) {
+		long httpCode = 0;
+		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+		return retryPolicy->isRetryable(httpCode, idempotent);
 	}
 
-	requestHeaders = curl_slist_append(requestHeaders, header.c_str());
+	return retryPolicy->isRetryable(rc, idempotent);
+}
+
+esl::io::Input Send::releaseInput() {
+	if(dataWritten) {
+		return esl::io::Input();
+	}
+	return std::move(input);
+}
+
+void Send::setStartHandler(std::function<bool ()> aStartHandler) {
+	startHandler = std::move(aStartHandler);
+}
+
+void Send::addRequestHeader(const std::string& key, const std::string& value) {
+	requestHeaders.add(key, value);
 }
 
 size_t Send::readDataCallback(void* data, size_t size, size_t nmemb, void* sendPtr) {
@@ -223,6 +400,12 @@ size_t Send::readDataCallback(void* data, size_t size, size_t nmemb, void* sendP
 }
 
 std::size_t Send::readData(void* data, std::size_t size) {
+	if(body.getType() == Body::Type::file) {
+		return body.readFile(data, size);
+	}
+
+	esl::io::Output& output = body.getOutput();
+
 	/* Signal libcurl to abort transmitting if there is no output available */
 	if(!output) {
 		return 0;
@@ -235,33 +418,40 @@ std::size_t Send::readData(void* data, std::size_t size) {
 		return 0;
 	}
 
+	/* reader has no data available yet, so pause instead of finishing the body */
+	if(rv == 0 && size > 0) {
+		sendPaused = true;
+		return CURL_READFUNC_PAUSE;
+	}
+
 	return rv;
 }
 
+int Send::seekDataCallback(void* sendPtr, curl_off_t offset, int origin) {
+	Send& send = *reinterpret_cast<Send*>(sendPtr);
+
+	/* libcurl rewinds the body e.g. for a redirect or if a reused connection was dead */
+	if(send.body.getType() != Body::Type::file || origin != SEEK_SET || offset < 0) {
+		return CURL_SEEKFUNC_CANTSEEK;
+	}
+	return send.body.seekFile(static_cast<std::uint64_t>(offset)) ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_FAIL;
+}
+
 size_t Send::writeHeaderCallback(void* data, size_t size, size_t nmemb, void* sendPtr) {
 	Send& send = *reinterpret_cast<Send*>(sendPtr);
 	return send.writeHeader(static_cast<char*>(data), size * nmemb);
 }
 
 std::size_t Send::writeHeader(const char* data, std::size_t size) {
-	std::string header(data, size);
-	std::size_t seperator = header.find_first_of(":");
-
-	std::string key;
-	std::string value;
-
-	if(seperator == std::string::npos) {
-		key = esl::utility::String::trim(esl::utility::String::trim(esl::utility::String::trim(header), '\n'), '\r');
-	}
-	else {
-		key = esl::utility::String::trim(esl::utility::String::trim(esl::utility::String::trim(header.substr(0, seperator)), '\n'), '\r');
-		value = esl::utility::String::trim(esl::utility::String::trim(esl::utility::String::trim(header.substr(seperator + 1)), '\n'), '\r');
-	}
-
-	if(!key.empty()) {
-		responseHeaders[key] = value;
+	if(startHandler) {
+		std::function<bool ()> handler = std::move(startHandler);
+		startHandler = nullptr;
+		if(!handler()) {
+			return 0;
+		}
 	}
 
+	responseHeaders.addLine(data, size);
 	return size;
 }
 
@@ -313,7 +503,28 @@ size_t Send::writeDataCallback(void* data, size_t size, size_t nmemb, void* send
 std::size_t Send::writeData(const std::uint8_t* data, const std::size_t size) {
 	if(firstWriteData) {
 		firstWriteData = false;
-		input = createInput(getResponse());
+
+		long httpCode = 0;
+		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+		if(retryPolicy && retryPolicy->isRetryable(httpCode, idempotent)) {
+			discardBody = true;
+		}
+		else if(createInput) {
+			input = createInput(getResponse());
+			if(blocking && pipelineDepth > 0 && input) {
+				pipeline.reset(new Pipeline(std::move(input), pipelineBuffers, pipelineDepth, writerStallTimeout));
+			}
+		}
+	}
+
+	if(discardBody) {
+		return size;
+	}
+	dataWritten = true;
+
+	if(pipeline) {
+		/* blocks while the queue is full, so the socket is not read faster than the writer consumes */
+		return pipeline->push(data, size) ? size : 0;
 	}
 
 	/* Signal libcurl to abort receiving if there is no input available */
@@ -325,10 +536,9 @@ std::size_t Send::writeData(const std::uint8_t* data, const std::size_t size) {
 	 * flush buffer if something has queued *
 	 * ************************************ */
 	while(receiveBuffer.empty() == false) {
-		Chunk& chunk = receiveBuffer.front();
-
-		std::size_t sizeRemaining = chunk.size() - currentPos;
-		std::size_t sizeWritten = input.getWriter().write(&chunk[currentPos], sizeRemaining);
+		std::size_t sizeRemaining = 0;
+		const std::uint8_t* chunk = receiveBuffer.front(sizeRemaining);
+		std::size_t sizeWritten = input.getWriter().write(chunk, sizeRemaining);
 
 		if(sizeWritten == esl::io::Writer::npos) {
 			input = esl::io::Input();
@@ -338,20 +548,18 @@ std::size_t Send::writeData(const std::uint8_t* data, const std::size_t size) {
 
 		/* check if writer is stalled */
 		if(sizeWritten == 0) {
-			if(size > 0) {
-				/* put new data into queue */
-				receiveBuffer.push_back(Chunk(size));
-				Chunk& chunk = receiveBuffer.back();
-				std::memcpy(&chunk[0], data, size);
+			/* let libcurl keep the data and stop receiving until the writer has drained the queue */
+			if(maxReceiveBuffer > 0 && receiveBuffer.size() + size > maxReceiveBuffer) {
+				receivePaused = true;
+				return CURL_WRITEFUNC_PAUSE;
 			}
+
+			/* put new data into queue */
+			receiveBuffer.append(data, size);
 			return size;
 		}
 
-		currentPos += sizeWritten;
-		if(currentPos == chunk.size()) {
-			currentPos = 0;
-			receiveBuffer.pop_front();
-		}
+		receiveBuffer.consume(sizeWritten);
 	}
 
 	/* ************************************************ *
@@ -367,7 +575,7 @@ std::size_t Send::writeData(const std::uint8_t* data, const std::size_t size) {
 	/* ********************* *
 	 * Writer data to writer *
 	 * ********************* */
-	currentPos = 0;
+	std::size_t currentPos = 0;
 	while(currentPos < size) {
 		std::size_t sizeRemaining = size - currentPos;
 		std::size_t sizeWritten = input.getWriter().write(&data[currentPos], sizeRemaining);
@@ -385,26 +593,145 @@ std::size_t Send::writeData(const std::uint8_t* data, const std::size_t size) {
 		currentPos += sizeWritten;
 	}
 
-	/* put unwritten  data into queue */
-	if(currentPos < size) {
-		std::size_t sizeRemaining = size - currentPos;
-		receiveBuffer.push_back(Chunk(sizeRemaining));
-		Chunk& chunk = receiveBuffer.back();
-		std::memcpy(&chunk[0], &data[currentPos], sizeRemaining);
-		currentPos = 0;
-	}
+	/* put unwritten  data into queue.
+	 * Part of this data has been written already, so it cannot be paused
+	 * and the queue might exceed maxReceiveBuffer by one chunk. */
+	receiveBuffer.append(&data[currentPos], size - currentPos);
 
 	return size;
 }
 
+bool Send::flushReceiveBuffer() {
+	while(input && receiveBuffer.empty() == false) {
+		std::size_t sizeRemaining = 0;
+		const std::uint8_t* chunk = receiveBuffer.front(sizeRemaining);
+		std::size_t sizeWritten = input.getWriter().write(chunk, sizeRemaining);
+
+		if(sizeWritten == esl::io::Writer::npos) {
+			input = esl::io::Input();
+			break;
+		}
+
+		/* the transfer is done, so it cannot be paused anymore, the caller decides to retry later or to give up */
+		if(sizeWritten == 0) {
+			return false;
+		}
+
+		writerStall.reset();
+		receiveBuffer.consume(sizeWritten);
+	}
+	receiveBuffer.clear();
+	return true;
+}
+
+void Send::abandonReceiveBuffer() {
+	input = esl::io::Input();
+	receiveBuffer.clear();
+
+	std::string str = "Fehlercode=" + std::to_string(CURLE_WRITE_ERROR) + " (" + curl_easy_strerror(CURLE_WRITE_ERROR) + ") writer has not taken the rest of the response body";
+	exceptionPtr = std::make_exception_ptr(esl::system::Stacktrace::add(esl::com::http::client::exception::NetworkError(static_cast<int>(CURLE_WRITE_ERROR), str)));
+}
+
+int Send::progressCallback(void* sendPtr, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+	Send& send = *reinterpret_cast<Send*>(sendPtr);
+	try {
+		send.progress();
+	}
+	catch(...) {
+		send.exceptionPtr = std::current_exception();
+		/* abort transfer */
+		return 1;
+	}
+
+	return 0;
+}
+
+void Send::progress() {
+	/* libcurl calls the read callback again within curl_easy_pause */
+	if(sendPaused) {
+		sendPaused = false;
+		updatePause();
+	}
+
+	if(!receivePaused) {
+		return;
+	}
+
+	while(input && receiveBuffer.empty() == false) {
+		std::size_t sizeRemaining = 0;
+		const std::uint8_t* chunk = receiveBuffer.front(sizeRemaining);
+		std::size_t sizeWritten = input.getWriter().write(chunk, sizeRemaining);
+
+		if(sizeWritten == esl::io::Writer::npos) {
+			input = esl::io::Input();
+			break;
+		}
+
+		/* writer is still stalled, stay paused */
+		if(sizeWritten == 0) {
+			return;
+		}
+
+		receiveBuffer.consume(sizeWritten);
+	}
+
+	if(!input) {
+		receiveBuffer.clear();
+	}
+
+	/* libcurl delivers the held back data within curl_easy_pause */
+	receivePaused = false;
+	updatePause();
+}
+
+bool Send::resume() {
+	if(!sendPaused && !receivePaused) {
+		return true;
+	}
+
+	try {
+		progress();
+	}
+	catch(...) {
+		exceptionPtr = std::current_exception();
+		return false;
+	}
+
+	return true;
+}
+
+bool Send::isPaused() const noexcept {
+	return sendPaused || receivePaused;
+}
+
+void Send::updatePause() {
+	int bitmask = CURLPAUSE_CONT;
+	if(receivePaused) {
+		bitmask |= CURLPAUSE_RECV;
+	}
+	if(sendPaused) {
+		bitmask |= CURLPAUSE_SEND;
+	}
+	curl_easy_pause(curl, bitmask);
+}
+
 const esl::com::http::client::Response& Send::getResponse() {
 	if(!response) {
 		long httpCode = 0;
 		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
 		responseStatusCode = static_cast<unsigned short>(httpCode);
 
+		if(contentDecoding) {
+			const std::string* contentEncoding = responseHeaders.find("Content-Encoding", 16);
+			if(contentEncoding && !isIdentityEncoding(*contentEncoding)) {
+				/* the writer gets the decoded body */
+				responseHeaders.remove("Content-Encoding", 16);
+				responseHeaders.remove("Content-Length", 14);
+			}
+		}
+
 		esl::utility::MIME contentType = findContentType(responseHeaders);
-		response.reset(new esl::com::http::client::Response(responseStatusCode, std::move(responseHeaders), std::move(contentType)));
+		response.reset(new esl::com::http::client::Response(responseStatusCode, responseHeaders.toMap(), std::move(contentType)));
 	}
 
 	return *response;
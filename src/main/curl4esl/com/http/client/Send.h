@@ -23,19 +23,29 @@ SOFTWARE.
 #ifndef CURL4ESL_COM_HTTP_CLIENT_SEND_H_
 #define CURL4ESL_COM_HTTP_CLIENT_SEND_H_
 
-#include <esl/com/http/client/Request.h>
 #include <esl/com/http/client/Response.h>
 #include <esl/io/Input.h>
 #include <esl/io/Output.h>
 
+#include <curl4esl/com/http/client/Body.h>
+#include <curl4esl/com/http/client/DnsCache.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/HeaderList.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+#include <curl4esl/com/http/client/Metrics.h>
+#include <curl4esl/com/http/client/Pipeline.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/ReceiveBuffer.h>
+#include <curl4esl/com/http/client/RetryPolicy.h>
+#include <curl4esl/com/http/client/WriterStall.h>
+
 #include <curl/curl.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <functional>
-#include <list>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -48,20 +58,71 @@ namespace client {
 
 class Send {
 public:
-	Send(CURL* curl, const esl::com::http::client::Request& request, const std::string& requestUrl, esl::io::Output& output, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput);
-	Send(CURL* curl, const esl::com::http::client::Request& request, const std::string& requestUrl, esl::io::Output& output, esl::io::Input input);
+	/* 'request' must stay valid until the transfer has been completed, 'headers' are added to the headers of 'request' */
+	Send(HandlePool::Handle& handle, const PreparedRequest& request, Body body, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers = nullptr);
+	Send(HandlePool::Handle& handle, const PreparedRequest& request, Body body, esl::io::Input input, const PreparedRequest::Headers* headers = nullptr);
 	~Send();
 
+	/* sets the callback functions, so only their user data has to be set for each transfer */
+	static void initHandle(CURL* curl);
+
+	/* performs the transfer blocking on the calling thread */
 	esl::com::http::client::Response execute();
 
+	/* Performs the transfer blocking on the calling thread without evaluating the result.
+	 * Waits for a stalled writer to take the data queued for it. */
+	CURLcode perform();
+
+	/* Writes data that has been queued for a stalled writer, after the transfer has finished successfully.
+	 * Returns false if the writer is still stalled, it has to be called again later. If the writer has been
+	 * stalled for longer than 'writer-stall-timeout', the data is dropped and complete(...) throws. */
+	bool drain();
+
+	/* records the result of a transfer in the metrics of the pool */
+	void record(CURLcode rc) noexcept;
+
+	/* evaluates the result of a transfer that has been performed by curl_easy_perform or a multi handle */
+	esl::com::http::client::Response complete(CURLcode rc);
+
+	/* If set, the body of a response with a retryable status code is discarded instead
+	 * of being passed to 'createInput' or the input, because the send is going to be retried. */
+	void setRetryPolicy(const RetryPolicy* retryPolicy) noexcept;
+
+	/* returns true if the retry policy is set and the result of the transfer allows a retry,
+	 * i.e. no data has been passed to the caller yet */
+	bool isRetryable(CURLcode rc) const;
+
+	/* Resumes a paused transfer outside of the callbacks of libcurl, like the progress callback does.
+	 * Returns false if the transfer has to be aborted, complete(...) throws the exception then. */
+	bool resume();
+
+	bool isPaused() const noexcept;
+
+	/* returns the input of the caller, if it has not been used by this send */
+	esl::io::Input releaseInput();
+
+	/* Called when the first header line of the response has been received.
+	 * If it returns false, the transfer is aborted with CURLE_WRITE_ERROR. */
+	void setStartHandler(std::function<bool ()> startHandler);
+
 private:
-	Send(CURL* curl, const esl::com::http::client::Request& request, const std::string& requestUrl, esl::io::Output& output, esl::io::Input input, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput);
+	Send(HandlePool::Handle& handle, const PreparedRequest& request, Body body, esl::io::Input input, std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput, const PreparedRequest::Headers* headers);
 
 	void addRequestHeader(const std::string& key, const std::string& value);
 
+	/* used for file bodies if 'upload-buffer-size' is not set, maximum of libcurl */
+	static constexpr long fileUploadBufferSize = 2 * 1024 * 1024;
+	/* default of libcurl, used for other bodies if 'upload-buffer-size' is not set */
+	static constexpr long defaultUploadBufferSize = 64 * 1024;
+
+	/* sets the upload buffer of the handle to the size needed by 'body' */
+	static void setUploadBufferSize(HandlePool::Handle& handle, const Body& body);
+
 	static size_t readDataCallback(void* data, size_t size, size_t nmemb, void* sendPtr);
 	std::size_t readData(void* data, std::size_t size);
 
+	static int seekDataCallback(void* sendPtr, curl_off_t offset, int origin);
+
 	/**
 	* @brief header callback for libcurl
 	*
@@ -86,26 +147,72 @@ private:
 	*/
 	static size_t writeDataCallback(void* data, size_t size, size_t nmemb, void* sendPtr);
 	std::size_t writeData(const std::uint8_t* data, const std::size_t size);
+	/* returns false if the writer is stalled and data is left in the receive buffer */
+	bool flushReceiveBuffer();
+	/* drops the data queued for a stalled writer, complete(...) throws then */
+	void abandonReceiveBuffer();
+
+	static int progressCallback(void* sendPtr, curl_off_t downloadTotal, curl_off_t downloadNow, curl_off_t uploadTotal, curl_off_t uploadNow);
+	void progress();
+
+	/* sets pause state of libcurl according to receivePaused and sendPaused */
+	void updatePause();
 
 	const esl::com::http::client::Response& getResponse();
 
 	CURL* curl;
 
-	curl_slist* requestHeaders = nullptr;
+	/* Headers of this send only, the headers of the prepared request are linked behind its tail.
+	 * Owned by the handle to reuse its memory. */
+	HeaderList& requestHeaders;
 
 	bool firstWriteData = true;
 	esl::io::Input input;
 	std::function<esl::io::Input (const esl::com::http::client::Response&)> createInput;
-	esl::io::Output& output;
+	Body body;
 
 	std::unique_ptr<esl::com::http::client::Response> response;
-	std::map<std::string, std::string> responseHeaders;
+	/* owned by the handle to reuse its memory */
+	HeaderStore& responseHeaders;
 	unsigned short responseStatusCode = 0;
 
-	using Chunk = std::vector<std::uint8_t>;
-	std::size_t currentPos = 0;
-
-	std::list<Chunk> receiveBuffer;
+	/* data received while the writer was stalled, owned by the handle to reuse its memory */
+	ReceiveBuffer& receiveBuffer;
+	/* transfer gets paused if receiveBuffer would exceed this size, 0 means unlimited */
+	std::size_t maxReceiveBuffer;
+	bool receivePaused = false;
+	/* setting 'writer-stall-timeout', used for the pipeline as well */
+	std::chrono::milliseconds writerStallTimeout;
+	/* writer that does not take the data queued for it after the transfer has finished */
+	WriterStall writerStall;
+	/* reader of the body had no data available */
+	bool sendPaused = false;
+
+	/* Setting 'pipeline-depth', only sends performed by perform() are pipelined,
+	 * because a full queue blocks the thread that drives the transfer. */
+	std::size_t pipelineDepth;
+	bool blocking = false;
+	/* owned by the handle to reuse its memory */
+	std::vector<std::vector<std::uint8_t>>& pipelineBuffers;
+	std::unique_ptr<Pipeline> pipeline;
+
+	/* libcurl decodes the body, so Content-Encoding and Content-Length are not valid for it anymore */
+	bool contentDecoding;
+
+	/* nullptr if metrics are disabled */
+	Metrics* metrics;
+
+	const RetryPolicy* retryPolicy = nullptr;
+	bool idempotent;
+	/* response body has been passed to the input */
+	bool dataWritten = false;
+	/* response gets retried, so its body is not passed to the input */
+	bool discardBody = false;
+
+	std::function<bool ()> startHandler;
+
+	/* kept until the transfer is done, libcurl reads it when the transfer starts */
+	std::shared_ptr<const DnsCache::ResolveList> resolveList;
 
 	std::exception_ptr exceptionPtr;
 };
@@ -0,0 +1,78 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/Share.h>
+
+#include <esl/system/Stacktrace.h>
+
+#include <stdexcept>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+Share::Share(bool shareConnections)
+: share(curl_share_init())
+{
+	if(share == nullptr) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl share init error"));
+	}
+
+	curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockCallback);
+	curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockCallback);
+	curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+	/* libcurl documents that sharing the connection cache between concurrently
+	 * running threads is not reliable, so this is enabled only on request. */
+	if(shareConnections) {
+		curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+	}
+}
+
+Share::~Share() {
+	curl_share_cleanup(share);
+}
+
+CURLSH* Share::get() const noexcept {
+	return share;
+}
+
+void Share::lockCallback(CURL*, curl_lock_data data, curl_lock_access, void* sharePtr) {
+	Share& share = *static_cast<Share*>(sharePtr);
+	share.mutexes[data].lock();
+}
+
+void Share::unlockCallback(CURL*, curl_lock_data data, void* sharePtr) {
+	Share& share = *static_cast<Share*>(sharePtr);
+	share.mutexes[data].unlock();
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
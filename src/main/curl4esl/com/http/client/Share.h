@@ -0,0 +1,62 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_SHARE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_SHARE_H_
+
+#include <curl/curl.h>
+
+#include <mutex>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Wrapper for a CURLSH object that lets all easy handles of a ConnectionFactory
+ * share DNS cache, TLS sessions and optionally the connection cache across threads. */
+class Share {
+public:
+	Share(bool shareConnections);
+	Share(const Share&) = delete;
+	~Share();
+
+	Share& operator=(const Share&) = delete;
+
+	CURLSH* get() const noexcept;
+
+private:
+	static void lockCallback(CURL* curl, curl_lock_data data, curl_lock_access access, void* sharePtr);
+	static void unlockCallback(CURL* curl, curl_lock_data data, void* sharePtr);
+
+	CURLSH* share = nullptr;
+	std::mutex mutexes[CURL_LOCK_DATA_LAST];
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_SHARE_H_ */
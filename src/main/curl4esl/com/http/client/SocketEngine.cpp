@@ -0,0 +1,392 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/SocketEngine.h>
+
+#include <esl/Logger.h>
+#include <esl/system/Stacktrace.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+esl::Logger logger("curl4esl::com::http::client::SocketEngine");
+
+/* same intervals as the event loop of MultiEngine */
+constexpr std::chrono::milliseconds resumeInterval(1000);
+constexpr std::chrono::milliseconds drainInterval(10);
+/* a paused transfer is resumed as soon as its writer might take data again, like a draining one */
+constexpr std::chrono::milliseconds pausedResumeInterval(10);
+}  // anonymer namespace
+
+constexpr int SocketEngine::eventIn;
+constexpr int SocketEngine::eventOut;
+constexpr int SocketEngine::eventError;
+
+SocketEngine::SocketEngine(bool multiplex, long maxConcurrentStreams, long maxConnects, SocketHandler aSocketHandler, TimerHandler aTimerHandler)
+: multi(curl_multi_init()),
+  socketHandler(std::move(aSocketHandler)),
+  timerHandler(std::move(aTimerHandler))
+{
+	if(multi == nullptr) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl multi init error"));
+	}
+
+	curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, socketCallback);
+	curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this);
+	curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, timerCallback);
+	curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this);
+
+	if(multiplex) {
+		curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+		curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, maxConcurrentStreams);
+	}
+
+	if(maxConnects > 0) {
+		curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, maxConnects);
+	}
+}
+
+SocketEngine::~SocketEngine() {
+	for(auto& entry : running) {
+		curl_multi_remove_handle(multi, entry.first);
+		done(std::move(entry.second), CURLE_ABORTED_BY_CALLBACK);
+	}
+	running.clear();
+
+	for(auto& transfer : draining) {
+		done(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	draining.clear();
+
+	for(auto& transfer : pending) {
+		done(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	pending.clear();
+
+	/* libcurl may report the removal of its remaining sockets to the socket handler */
+	curl_multi_cleanup(multi);
+}
+
+void SocketEngine::add(std::unique_ptr<MultiEngine::Transfer> transfer) {
+	if(dispatching) {
+		pending.push_back(std::move(transfer));
+		return;
+	}
+
+	start(std::move(transfer));
+	updateTimer();
+}
+
+void SocketEngine::onSocket(curl_socket_t socket, int events) {
+	int mask = 0;
+	if(events & eventIn) {
+		mask |= CURL_CSELECT_IN;
+	}
+	if(events & eventOut) {
+		mask |= CURL_CSELECT_OUT;
+	}
+	if(events & eventError) {
+		mask |= CURL_CSELECT_ERR;
+	}
+
+	dispatch(socket, mask);
+}
+
+void SocketEngine::onTimeout() {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	hasArmedDeadline = false;
+
+	/* libcurl reports a new timeout while handling the expired one, if there is any */
+	if(hasCurlDeadline && curlDeadline <= now) {
+		hasCurlDeadline = false;
+	}
+
+	if(now >= nextResume) {
+		resume();
+	}
+	if(!draining.empty() && now >= nextDrain) {
+		drain();
+	}
+	dispatch(CURL_SOCKET_TIMEOUT, 0);
+}
+
+std::size_t SocketEngine::getRunning() const noexcept {
+	return running.size() + draining.size();
+}
+
+int SocketEngine::socketCallback(CURL*, curl_socket_t socket, int what, void* enginePtr, void*) {
+	SocketEngine& engine = *static_cast<SocketEngine*>(enginePtr);
+
+	int events = 0;
+	switch(what) {
+	case CURL_POLL_IN:
+		events = eventIn;
+		break;
+	case CURL_POLL_OUT:
+		events = eventOut;
+		break;
+	case CURL_POLL_INOUT:
+		events = eventIn | eventOut;
+		break;
+	default:
+		break;
+	}
+
+	try {
+		engine.socketHandler(socket, events);
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in socket handler: " << e.what() << "\n";
+		return -1;
+	}
+	catch(...) {
+		logger.warn << "unknown exception in socket handler\n";
+		return -1;
+	}
+
+	return 0;
+}
+
+int SocketEngine::timerCallback(CURLM*, long timeoutMs, void* enginePtr) {
+	SocketEngine& engine = *static_cast<SocketEngine*>(enginePtr);
+
+	/* reported to the event loop by updateTimer(), libcurl does not allow calls of the multi API from here */
+	engine.hasCurlDeadline = timeoutMs >= 0;
+	if(engine.hasCurlDeadline) {
+		engine.curlDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	}
+
+	return 0;
+}
+
+void SocketEngine::start(std::unique_ptr<MultiEngine::Transfer> transfer) {
+	bool started = false;
+	try {
+		started = transfer->start();
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in start of transfer: " << e.what() << "\n";
+	}
+	catch(...) {
+		logger.warn << "unknown exception in start of transfer\n";
+	}
+
+	if(!started) {
+		done(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+		return;
+	}
+
+	CURL* curl = transfer->getHandle();
+	CURLMcode mc = curl_multi_add_handle(multi, curl);
+	if(mc != CURLM_OK) {
+		logger.warn << "curl_multi_add_handle failed: " << curl_multi_strerror(mc) << "\n";
+		done(std::move(transfer), CURLE_FAILED_INIT);
+		return;
+	}
+
+	if(running.empty()) {
+		nextResume = std::chrono::steady_clock::now() + resumeInterval;
+	}
+	running[curl] = std::move(transfer);
+}
+
+void SocketEngine::dispatch(curl_socket_t socket, int mask) {
+	dispatching = true;
+
+	int stillRunning = 0;
+	curl_multi_socket_action(multi, socket, mask, &stillRunning);
+
+	int messagesLeft = 0;
+	while(CURLMsg* message = curl_multi_info_read(multi, &messagesLeft)) {
+		if(message->msg != CURLMSG_DONE) {
+			continue;
+		}
+
+		CURL* curl = message->easy_handle;
+		CURLcode code = message->data.result;
+		curl_multi_remove_handle(multi, curl);
+
+		auto iter = running.find(curl);
+		if(iter != running.end()) {
+			std::unique_ptr<MultiEngine::Transfer> transfer = std::move(iter->second);
+			running.erase(iter);
+			finish(std::move(transfer), code);
+		}
+	}
+
+	dispatching = false;
+
+	std::vector<std::unique_ptr<MultiEngine::Transfer>> added;
+	added.swap(pending);
+	for(auto& transfer : added) {
+		start(std::move(transfer));
+	}
+
+	updateTimer();
+}
+
+void SocketEngine::resume() {
+	nextResume = std::chrono::steady_clock::now() + resumeInterval;
+
+	std::vector<CURL*> failed;
+	for(auto& entry : running) {
+		bool resumed = false;
+		try {
+			resumed = entry.second->resume();
+		}
+		catch(...) {
+		}
+		if(!resumed) {
+			failed.push_back(entry.first);
+		}
+	}
+
+	for(auto curl : failed) {
+		abort(curl);
+	}
+}
+
+void SocketEngine::finish(std::unique_ptr<MultiEngine::Transfer> transfer, CURLcode code) {
+	if(code == CURLE_OK && !drain(*transfer)) {
+		if(draining.empty()) {
+			nextDrain = std::chrono::steady_clock::now() + drainInterval;
+		}
+		draining.push_back(std::move(transfer));
+		return;
+	}
+	done(std::move(transfer), code);
+}
+
+void SocketEngine::drain() {
+	nextDrain = std::chrono::steady_clock::now() + drainInterval;
+
+	/* completions may add new transfers, so they are not called while iterating */
+	std::vector<std::unique_ptr<MultiEngine::Transfer>> drained;
+	for(std::size_t i = 0; i < draining.size();) {
+		if(drain(*draining[i])) {
+			drained.push_back(std::move(draining[i]));
+			draining.erase(draining.begin() + i);
+			continue;
+		}
+		++i;
+	}
+
+	for(auto& transfer : drained) {
+		done(std::move(transfer), CURLE_OK);
+	}
+}
+
+void SocketEngine::abort(CURL* curl) {
+	auto iter = running.find(curl);
+	if(iter == running.end()) {
+		return;
+	}
+
+	std::unique_ptr<MultiEngine::Transfer> transfer = std::move(iter->second);
+	running.erase(iter);
+	curl_multi_remove_handle(multi, curl);
+	done(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+}
+
+void SocketEngine::updateTimer() {
+	std::chrono::steady_clock::time_point pausedResume = std::chrono::steady_clock::now() + pausedResumeInterval;
+	if(nextResume > pausedResume) {
+		for(const auto& entry : running) {
+			if(entry.second->isPaused()) {
+				nextResume = pausedResume;
+				break;
+			}
+		}
+	}
+
+	bool hasDeadline = hasCurlDeadline;
+	std::chrono::steady_clock::time_point deadline = curlDeadline;
+	if(!running.empty() && (!hasDeadline || nextResume < deadline)) {
+		hasDeadline = true;
+		deadline = nextResume;
+	}
+	if(!draining.empty() && (!hasDeadline || nextDrain < deadline)) {
+		hasDeadline = true;
+		deadline = nextDrain;
+	}
+
+	if(hasDeadline == hasArmedDeadline && (!hasDeadline || deadline == armedDeadline)) {
+		return;
+	}
+	hasArmedDeadline = hasDeadline;
+	armedDeadline = deadline;
+
+	long timeoutMs = -1;
+	if(hasDeadline) {
+		/* rounded up, so the event loop does not call onTimeout() before the deadline */
+		auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count();
+		timeoutMs = remaining > 0 ? static_cast<long>((remaining + 999) / 1000) : 0;
+	}
+
+	try {
+		timerHandler(timeoutMs);
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in timer handler: " << e.what() << "\n";
+	}
+	catch(...) {
+		logger.warn << "unknown exception in timer handler\n";
+	}
+}
+
+bool SocketEngine::drain(MultiEngine::Transfer& transfer) {
+	try {
+		return transfer.drain();
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in drain of transfer: " << e.what() << "\n";
+	}
+	catch(...) {
+		logger.warn << "unknown exception in drain of transfer\n";
+	}
+	return true;
+}
+
+void SocketEngine::done(std::unique_ptr<MultiEngine::Transfer> transfer, CURLcode code) {
+	try {
+		transfer->done(code);
+	}
+	catch(const std::exception& e) {
+		logger.warn << "exception in completion of transfer: " << e.what() << "\n";
+	}
+	catch(...) {
+		logger.warn << "unknown exception in completion of transfer\n";
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,122 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_SOCKETENGINE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_SOCKETENGINE_H_
+
+#include <curl4esl/com/http/client/MultiEngine.h>
+
+#include <curl/curl.h>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Drives a curl_multi handle by curl_multi_socket_action on the thread of an external
+ * event loop, so transfers need no thread of their own. The engine reports the sockets
+ * to watch and the timer to arm. The event loop calls onSocket(...) and onTimeout() when
+ * they fire. All methods, the handlers and the completions of the transfers run on the
+ * event loop thread. The engine must not be destroyed within a handler or a completion. */
+class SocketEngine {
+public:
+	static constexpr int eventIn = 1;
+	static constexpr int eventOut = 2;
+	/* only passed to onSocket(...) */
+	static constexpr int eventError = 4;
+
+	/* 'events' is a combination of eventIn and eventOut, 0 means that the socket must not be watched anymore */
+	using SocketHandler = std::function<void (curl_socket_t socket, int events)>;
+	/* -1 disarms the timer, 0 means that onTimeout() should be called as soon as possible */
+	using TimerHandler = std::function<void (long timeoutMs)>;
+
+	SocketEngine(bool multiplex, long maxConcurrentStreams, long maxConnects, SocketHandler socketHandler, TimerHandler timerHandler);
+	SocketEngine(const SocketEngine&) = delete;
+	/* transfers that are still running are done with CURLE_ABORTED_BY_CALLBACK */
+	~SocketEngine();
+
+	SocketEngine& operator=(const SocketEngine&) = delete;
+
+	/* starts the transfer, it is done by a later call of onSocket(...) or onTimeout() */
+	void add(std::unique_ptr<MultiEngine::Transfer> transfer);
+
+	void onSocket(curl_socket_t socket, int events);
+	void onTimeout();
+
+	std::size_t getRunning() const noexcept;
+
+private:
+	static int socketCallback(CURL* curl, curl_socket_t socket, int what, void* enginePtr, void* socketPtr);
+	static int timerCallback(CURLM* multi, long timeoutMs, void* enginePtr);
+
+	void start(std::unique_ptr<MultiEngine::Transfer> transfer);
+	void dispatch(curl_socket_t socket, int mask);
+	/* resumes paused transfers, because libcurl does not call their progress callback in socket mode */
+	void resume();
+	/* completes a finished transfer or keeps it for draining */
+	void finish(std::unique_ptr<MultiEngine::Transfer> transfer, CURLcode code);
+	/* calls the stalled writers of finished transfers again */
+	void drain();
+	void abort(CURL* curl);
+	/* reports the earlier one of libcurl's timeout and the next resume to the event loop, if it has changed */
+	void updateTimer();
+
+	static bool drain(MultiEngine::Transfer& transfer);
+	static void done(std::unique_ptr<MultiEngine::Transfer> transfer, CURLcode code);
+
+	CURLM* multi;
+	SocketHandler socketHandler;
+	TimerHandler timerHandler;
+
+	std::map<CURL*, std::unique_ptr<MultiEngine::Transfer>> running;
+
+	/* finished transfers waiting for a stalled writer */
+	std::vector<std::unique_ptr<MultiEngine::Transfer>> draining;
+	std::chrono::steady_clock::time_point nextDrain;
+
+	/* transfers added while libcurl is being driven, they are started afterwards */
+	bool dispatching = false;
+	std::vector<std::unique_ptr<MultiEngine::Transfer>> pending;
+
+	bool hasCurlDeadline = false;
+	std::chrono::steady_clock::time_point curlDeadline;
+	std::chrono::steady_clock::time_point nextResume;
+
+	bool hasArmedDeadline = false;
+	std::chrono::steady_clock::time_point armedDeadline;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_SOCKETENGINE_H_ */
@@ -0,0 +1,74 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/Timing.h>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+std::chrono::microseconds getTime(CURL* curl, CURLINFO info) {
+	curl_off_t value = 0;
+	if(curl_easy_getinfo(curl, info, &value) != CURLE_OK) {
+		return std::chrono::microseconds(0);
+	}
+	return std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(value));
+}
+
+std::uint64_t getSize(CURL* curl, CURLINFO info) {
+	curl_off_t value = 0;
+	if(curl_easy_getinfo(curl, info, &value) != CURLE_OK || value < 0) {
+		return 0;
+	}
+	return static_cast<std::uint64_t>(value);
+}
+}  // anonymer namespace
+
+Timing::Timing(CURL* curl)
+: nameLookup(getTime(curl, CURLINFO_NAMELOOKUP_TIME_T)),
+  connect(getTime(curl, CURLINFO_CONNECT_TIME_T)),
+  appConnect(getTime(curl, CURLINFO_APPCONNECT_TIME_T)),
+  preTransfer(getTime(curl, CURLINFO_PRETRANSFER_TIME_T)),
+  startTransfer(getTime(curl, CURLINFO_STARTTRANSFER_TIME_T)),
+  total(getTime(curl, CURLINFO_TOTAL_TIME_T)),
+  bytesUploaded(getSize(curl, CURLINFO_SIZE_UPLOAD_T)),
+  bytesDownloaded(getSize(curl, CURLINFO_SIZE_DOWNLOAD_T))
+{
+	long numConnects = 0;
+	if(curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &numConnects) == CURLE_OK) {
+		connectionReused = (numConnects == 0);
+	}
+
+	char* ip = nullptr;
+	if(curl_easy_getinfo(curl, CURLINFO_PRIMARY_IP, &ip) == CURLE_OK && ip) {
+		primaryIp = ip;
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
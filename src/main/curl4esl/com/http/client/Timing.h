@@ -0,0 +1,69 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_TIMING_H_
+#define CURL4ESL_COM_HTTP_CLIENT_TIMING_H_
+
+#include <curl/curl.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Phase timings and transfer details of a completed send.
+ * All times are measured from the start of the transfer. */
+struct Timing {
+	Timing() = default;
+
+	/* reads the values of the last transfer performed by 'curl' */
+	explicit Timing(CURL* curl);
+
+	std::chrono::microseconds nameLookup { 0 };
+	std::chrono::microseconds connect { 0 };
+	/* TLS handshake completed, 0 for plain HTTP */
+	std::chrono::microseconds appConnect { 0 };
+	std::chrono::microseconds preTransfer { 0 };
+	/* first byte of the response received */
+	std::chrono::microseconds startTransfer { 0 };
+	std::chrono::microseconds total { 0 };
+
+	std::uint64_t bytesUploaded = 0;
+	std::uint64_t bytesDownloaded = 0;
+
+	/* true if no new connection had to be established */
+	bool connectionReused = false;
+	std::string primaryIp;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_TIMING_H_ */
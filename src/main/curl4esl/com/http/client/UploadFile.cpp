@@ -0,0 +1,139 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/UploadFile.h>
+
+#include <esl/system/Stacktrace.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+constexpr std::uint64_t UploadFile::npos;
+
+UploadFile::UploadFile(const std::string& path)
+: fd(-1),
+  ownsFd(true),
+  offset(0)
+{
+#ifdef _WIN32
+    throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: file upload is not supported on this platform"));
+#else
+	fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: cannot open file \"" + path + "\": " + std::strerror(errno)));
+	}
+
+	try {
+		init(npos);
+	}
+	catch(...) {
+		::close(fd);
+		throw;
+	}
+#endif
+}
+
+UploadFile::UploadFile(int aFd, std::uint64_t aOffset, std::uint64_t aSize)
+: fd(aFd),
+  ownsFd(false),
+  offset(aOffset)
+{
+#ifdef _WIN32
+    throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: file upload is not supported on this platform"));
+#else
+	init(aSize);
+#endif
+}
+
+UploadFile::~UploadFile() {
+#ifndef _WIN32
+	if(ownsFd && fd >= 0) {
+		::close(fd);
+	}
+#endif
+}
+
+std::uint64_t UploadFile::getSize() const noexcept {
+	return size;
+}
+
+std::size_t UploadFile::read(void* data, std::size_t aSize, std::uint64_t position) const {
+	if(position >= size) {
+		return 0;
+	}
+	aSize = static_cast<std::size_t>(std::min<std::uint64_t>(aSize, size - position));
+
+#ifndef _WIN32
+	while(true) {
+		ssize_t rc = ::pread(fd, data, aSize, static_cast<off_t>(offset + position));
+		if(rc >= 0) {
+			return static_cast<std::size_t>(rc);
+		}
+		if(errno != EINTR) {
+	        throw esl::system::Stacktrace::add(std::runtime_error(std::string("curl4esl: reading upload file failed: ") + std::strerror(errno)));
+		}
+	}
+#else
+	return 0;
+#endif
+}
+
+void UploadFile::init(std::uint64_t aSize) {
+#ifndef _WIN32
+	struct stat st;
+	if(::fstat(fd, &st) != 0) {
+        throw esl::system::Stacktrace::add(std::runtime_error(std::string("curl4esl: cannot stat upload file: ") + std::strerror(errno)));
+	}
+
+	std::uint64_t fileSize = static_cast<std::uint64_t>(st.st_size);
+	if(offset > fileSize) {
+        throw esl::system::Stacktrace::add(std::runtime_error("curl4esl: offset " + std::to_string(offset) + " is behind end of upload file"));
+	}
+
+	size = std::min(aSize, fileSize - offset);
+
+#ifdef POSIX_FADV_SEQUENTIAL
+	/* larger read ahead, the file is read from begin to end */
+	::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
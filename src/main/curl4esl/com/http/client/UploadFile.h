@@ -0,0 +1,76 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_UPLOADFILE_H_
+#define CURL4ESL_COM_HTTP_CLIENT_UPLOADFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* File that is sent as request body. Its size is known in advance, so the body is
+ * not chunked, and it is read with pread directly into the upload buffer of libcurl.
+ * Reads are stateless, so the same file can be sent by several transfers at the same time
+ * and libcurl can rewind it. POSIX only. */
+class UploadFile {
+public:
+	/* opens 'path', the file gets closed by the destructor */
+	UploadFile(const std::string& path);
+
+	/* Sends 'size' bytes of 'fd' starting at 'offset'. If 'size' is npos, everything behind 'offset' is sent.
+	 * 'fd' is not closed and must stay open as long as this object exists. */
+	UploadFile(int fd, std::uint64_t offset = 0, std::uint64_t size = npos);
+
+	UploadFile(const UploadFile&) = delete;
+	~UploadFile();
+
+	UploadFile& operator=(const UploadFile&) = delete;
+
+	static constexpr std::uint64_t npos = static_cast<std::uint64_t>(-1);
+
+	std::uint64_t getSize() const noexcept;
+
+	/* reads up to 'size' bytes at 'position' relative to the offset, returns 0 at end of file */
+	std::size_t read(void* data, std::size_t size, std::uint64_t position) const;
+
+private:
+	void init(std::uint64_t size);
+
+	int fd;
+	bool ownsFd;
+	std::uint64_t offset;
+	std::uint64_t size = 0;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_UPLOADFILE_H_ */
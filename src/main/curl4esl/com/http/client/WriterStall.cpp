@@ -0,0 +1,73 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/WriterStall.h>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+constexpr std::chrono::milliseconds minBackoff(1);
+constexpr std::chrono::milliseconds maxBackoff(100);
+}  // anonymer namespace
+
+WriterStall::WriterStall(std::chrono::milliseconds aTimeout)
+: timeout(aTimeout)
+{ }
+
+void WriterStall::reset() noexcept {
+	stalled = false;
+	backoff = minBackoff;
+}
+
+bool WriterStall::stall() {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	if(!stalled) {
+		stalled = true;
+		since = now;
+		backoff = minBackoff;
+		return true;
+	}
+
+	if(backoff * 2 <= maxBackoff) {
+		backoff *= 2;
+	}
+	else {
+		backoff = maxBackoff;
+	}
+
+	return timeout.count() == 0 || now - since <= timeout;
+}
+
+std::chrono::milliseconds WriterStall::getBackoff() const noexcept {
+	return backoff;
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
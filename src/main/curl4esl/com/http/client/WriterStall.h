@@ -0,0 +1,65 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_WRITERSTALL_H_
+#define CURL4ESL_COM_HTTP_CLIENT_WRITERSTALL_H_
+
+#include <chrono>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* A writer returns 0 if it cannot take data at the moment, but it does not signal
+ * when it can take data again. So it is called again after a backoff that grows
+ * while it stays stalled, and it is given up if it has not taken data for 'timeout'. */
+class WriterStall {
+public:
+	/* 0 never gives up the writer */
+	WriterStall(std::chrono::milliseconds timeout);
+
+	/* called if the writer has taken data */
+	void reset() noexcept;
+
+	/* Called if the writer has not taken data.
+	 * Returns false if it has been stalled for longer than the timeout. */
+	bool stall();
+
+	/* time to wait before the writer is called again */
+	std::chrono::milliseconds getBackoff() const noexcept;
+
+private:
+	std::chrono::milliseconds timeout;
+	bool stalled = false;
+	std::chrono::steady_clock::time_point since;
+	std::chrono::milliseconds backoff { 1 };
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_WRITERSTALL_H_ */
@@ -28,6 +28,8 @@ SOFTWARE.
 
 #include <curl4esl/com/http/client/ConnectionFactory.h>
 
+#include <curl/curl.h>
+
 #include <stdexcept>
 
 namespace esl {
@@ -36,12 +38,71 @@ namespace com {
 namespace http {
 namespace client {
 
+namespace {
+/* libcurl fails a transfer with a coding it cannot decode, so only codings it has been built with are accepted */
+bool isContentCodingSupported(const std::string& coding) {
+	if(coding == "identity") {
+		return true;
+	}
+
+	const curl_version_info_data* versionInfo = curl_version_info(CURLVERSION_NOW);
+	if(coding == "gzip" || coding == "deflate") {
+		return (versionInfo->features & CURL_VERSION_LIBZ) != 0;
+	}
+	if(coding == "br") {
+		return (versionInfo->features & CURL_VERSION_BROTLI) != 0;
+	}
+	if(coding == "zstd") {
+		return (versionInfo->features & CURL_VERSION_ZSTD) != 0;
+	}
+	return false;
+}
+}  // anonymer namespace
+
 CURLConnectionFactory::Settings::Settings(const std::vector<std::pair<std::string, std::string>>& settings) {
 	bool hasLowSpeedLimit = false;
 	bool hasLowSpeedTime = false;
 	bool hasUserAgent = false;
 	bool hasTimeout = false;
 	bool hasSkipSSLVerification = false;
+	bool hasPoolMaxIdle = false;
+	bool hasPoolMaxLifetime = false;
+	bool hasPoolIdleTimeout = false;
+	bool hasShareConnectionCache = false;
+	bool hasHttpVersion = false;
+	bool hasMultiplex = false;
+	bool hasMaxConcurrentStreams = false;
+	bool hasSharedConnection = false;
+	bool hasDnsRefresh = false;
+	bool hasBatchConcurrency = false;
+	bool hasMaxReceiveBuffer = false;
+	bool hasWriterStallTimeout = false;
+	bool hasPipelineDepth = false;
+	bool hasMetrics = false;
+	bool hasRetryMaxAttempts = false;
+	bool hasRetryBaseBackoff = false;
+	bool hasRetryMaxBackoff = false;
+	bool hasRetryCurlCodes = false;
+	bool hasRetryStatusCodes = false;
+	bool hasRetryBudget = false;
+	bool hasRetryBudgetMin = false;
+	bool hasHedgeDelay = false;
+	bool hasHedgeMaxRate = false;
+	bool hasCacheSize = false;
+	bool hasDownloadSegments = false;
+	bool hasDownloadMinSegmentSize = false;
+	bool hasDownloadSegmentAttempts = false;
+	bool hasBufferSize = false;
+	bool hasUploadBufferSize = false;
+	bool hasTcpNoDelay = false;
+	bool hasTcpKeepAliveIdle = false;
+	bool hasTcpKeepAliveInterval = false;
+	bool hasConnectTimeoutMs = false;
+	bool hasTimeoutMs = false;
+	bool hasExpect100TimeoutMs = false;
+	bool hasMaxConnects = false;
+	bool hasIpVersion = false;
+	std::string profile;
 
     for(const auto& setting : settings) {
 		if(setting.first == "url") {
@@ -166,6 +227,536 @@ CURLConnectionFactory::Settings::Settings(const std::vector<std::pair<std::strin
 			}
 		}
 
+		else if(setting.first == "pool-max-idle") {
+			if(hasPoolMaxIdle) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'pool-max-idle'."));
+			}
+			hasPoolMaxIdle = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'pool-max-idle'."));
+			}
+			poolMaxIdle = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "pool-max-lifetime") {
+			if(hasPoolMaxLifetime) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'pool-max-lifetime'."));
+			}
+			hasPoolMaxLifetime = true;
+			poolMaxLifetime = utility::String::toNumber<decltype(poolMaxLifetime)>(setting.second);
+			if(poolMaxLifetime < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(poolMaxLifetime) + "\" for attribute 'pool-max-lifetime'."));
+			}
+		}
+
+		else if(setting.first == "pool-idle-timeout") {
+			if(hasPoolIdleTimeout) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'pool-idle-timeout'."));
+			}
+			hasPoolIdleTimeout = true;
+			poolIdleTimeout = utility::String::toNumber<decltype(poolIdleTimeout)>(setting.second);
+			if(poolIdleTimeout < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(poolIdleTimeout) + "\" for attribute 'pool-idle-timeout'."));
+			}
+		}
+
+		else if(setting.first == "share-connection-cache") {
+			if(hasShareConnectionCache) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'share-connection-cache'."));
+			}
+			hasShareConnectionCache = true;
+			std::string value = utility::String::toLower(setting.second);
+			if(value == "true") {
+				shareConnectionCache = true;
+			}
+			else if(value == "false") {
+				shareConnectionCache = false;
+			}
+			else {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'share-connection-cache'"));
+			}
+		}
+
+		else if(setting.first == "http-version") {
+			if(hasHttpVersion) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'http-version'."));
+			}
+			hasHttpVersion = true;
+			std::string value = utility::String::toLower(setting.second);
+			if(value == "1.1") {
+				httpVersion = HttpVersion::http1_1;
+			}
+			else if(value == "2") {
+				httpVersion = HttpVersion::http2;
+			}
+			else if(value == "2-prior-knowledge") {
+				httpVersion = HttpVersion::http2PriorKnowledge;
+			}
+			else {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'http-version'"));
+			}
+		}
+
+		else if(setting.first == "multiplex") {
+			if(hasMultiplex) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'multiplex'."));
+			}
+			hasMultiplex = true;
+			std::string value = utility::String::toLower(setting.second);
+			if(value == "true") {
+				multiplex = true;
+			}
+			else if(value == "false") {
+				multiplex = false;
+			}
+			else {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'multiplex'"));
+			}
+		}
+
+		else if(setting.first == "shared-connection") {
+			if(hasSharedConnection) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'shared-connection'."));
+			}
+			hasSharedConnection = true;
+			std::string value = utility::String::toLower(setting.second);
+			if(value == "true") {
+				sharedConnection = true;
+			}
+			else if(value == "false") {
+				sharedConnection = false;
+			}
+			else {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'shared-connection'"));
+			}
+		}
+
+		else if(setting.first == "dns-refresh") {
+			if(hasDnsRefresh) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'dns-refresh'."));
+			}
+			hasDnsRefresh = true;
+			dnsRefresh = utility::String::toNumber<decltype(dnsRefresh)>(setting.second);
+			if(dnsRefresh < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(dnsRefresh) + "\" for attribute 'dns-refresh'."));
+			}
+		}
+
+		else if(setting.first == "max-concurrent-streams") {
+			if(hasMaxConcurrentStreams) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'max-concurrent-streams'."));
+			}
+			hasMaxConcurrentStreams = true;
+			maxConcurrentStreams = utility::String::toNumber<decltype(maxConcurrentStreams)>(setting.second);
+			if(maxConcurrentStreams < 1) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(maxConcurrentStreams) + "\" for attribute 'max-concurrent-streams'."));
+			}
+		}
+
+		else if(setting.first == "batch-concurrency") {
+			if(hasBatchConcurrency) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'batch-concurrency'."));
+			}
+			hasBatchConcurrency = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 1) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'batch-concurrency'."));
+			}
+			batchConcurrency = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "max-receive-buffer") {
+			if(hasMaxReceiveBuffer) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'max-receive-buffer'."));
+			}
+			hasMaxReceiveBuffer = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'max-receive-buffer'."));
+			}
+			maxReceiveBuffer = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "writer-stall-timeout") {
+			if(hasWriterStallTimeout) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'writer-stall-timeout'."));
+			}
+			hasWriterStallTimeout = true;
+			writerStallTimeout = utility::String::toNumber<decltype(writerStallTimeout)>(setting.second);
+			if(writerStallTimeout < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(writerStallTimeout) + "\" for attribute 'writer-stall-timeout'."));
+			}
+		}
+
+		else if(setting.first == "accept-encoding") {
+			if(hasAcceptEncoding) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'accept-encoding'."));
+			}
+			hasAcceptEncoding = true;
+			std::string value = utility::String::toLower(utility::String::trim(setting.second));
+			if(value == "all") {
+				acceptEncoding.clear();
+			}
+			else {
+				for(const auto& part : utility::String::split(value, ',')) {
+					std::string coding = utility::String::trim(part);
+					if(!isContentCodingSupported(coding)) {
+				    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'accept-encoding', coding \"" + coding + "\" is not supported."));
+					}
+					if(!acceptEncoding.empty()) {
+						acceptEncoding += ", ";
+					}
+					acceptEncoding += coding;
+				}
+				if(acceptEncoding.empty()) {
+			    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'accept-encoding'"));
+				}
+			}
+		}
+
+		else if(setting.first == "retry-max-attempts") {
+			if(hasRetryMaxAttempts) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'retry-max-attempts'."));
+			}
+			hasRetryMaxAttempts = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 1) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'retry-max-attempts'."));
+			}
+			retryMaxAttempts = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "retry-base-backoff") {
+			if(hasRetryBaseBackoff) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'retry-base-backoff'."));
+			}
+			hasRetryBaseBackoff = true;
+			retryBaseBackoff = utility::String::toNumber<decltype(retryBaseBackoff)>(setting.second);
+			if(retryBaseBackoff < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(retryBaseBackoff) + "\" for attribute 'retry-base-backoff'."));
+			}
+		}
+
+		else if(setting.first == "retry-max-backoff") {
+			if(hasRetryMaxBackoff) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'retry-max-backoff'."));
+			}
+			hasRetryMaxBackoff = true;
+			retryMaxBackoff = utility::String::toNumber<decltype(retryMaxBackoff)>(setting.second);
+			if(retryMaxBackoff < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(retryMaxBackoff) + "\" for attribute 'retry-max-backoff'."));
+			}
+		}
+
+		else if(setting.first == "retry-curl-codes") {
+			if(hasRetryCurlCodes) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'retry-curl-codes'."));
+			}
+			hasRetryCurlCodes = true;
+			retryCurlCodes.clear();
+			for(const auto& part : utility::String::split(setting.second, ',')) {
+				std::string code = utility::String::trim(part);
+				if(code.empty()) {
+					continue;
+				}
+				int value = utility::String::toNumber<int>(code);
+				if(value <= CURLE_OK || value >= CURL_LAST) {
+		            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + code + "\" for attribute 'retry-curl-codes'."));
+				}
+				retryCurlCodes.push_back(value);
+			}
+		}
+
+		else if(setting.first == "retry-status-codes") {
+			if(hasRetryStatusCodes) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'retry-status-codes'."));
+			}
+			hasRetryStatusCodes = true;
+			retryStatusCodes.clear();
+			for(const auto& part : utility::String::split(setting.second, ',')) {
+				std::string code = utility::String::trim(part);
+				if(code.empty()) {
+					continue;
+				}
+				long value = utility::String::toNumber<long>(code);
+				if(value < 100 || value > 599) {
+		            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + code + "\" for attribute 'retry-status-codes'."));
+				}
+				retryStatusCodes.push_back(value);
+			}
+		}
+
+		else if(setting.first == "retry-budget") {
+			if(hasRetryBudget) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'retry-budget'."));
+			}
+			hasRetryBudget = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'retry-budget'."));
+			}
+			retryBudget = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "retry-budget-min") {
+			if(hasRetryBudgetMin) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'retry-budget-min'."));
+			}
+			hasRetryBudgetMin = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'retry-budget-min'."));
+			}
+			retryBudgetMin = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "hedge-delay") {
+			if(hasHedgeDelay) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'hedge-delay'."));
+			}
+			hasHedgeDelay = true;
+			std::string value = utility::String::toLower(utility::String::trim(setting.second));
+			if(!value.empty() && value[0] == 'p') {
+				long percentile = utility::String::toNumber<long>(value.substr(1));
+				if(percentile < 1 || percentile > 99) {
+		            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'hedge-delay'."));
+				}
+				hedgeDelayPercentile = static_cast<std::size_t>(percentile);
+			}
+			else {
+				hedgeDelay = utility::String::toNumber<decltype(hedgeDelay)>(value);
+				if(hedgeDelay < 0) {
+		            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'hedge-delay'."));
+				}
+			}
+		}
+
+		else if(setting.first == "hedge-max-rate") {
+			if(hasHedgeMaxRate) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'hedge-max-rate'."));
+			}
+			hasHedgeMaxRate = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 0 || value > 100) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'hedge-max-rate'."));
+			}
+			hedgeMaxRate = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "profile") {
+			if(!profile.empty()) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'profile'."));
+			}
+			profile = utility::String::toLower(setting.second);
+			if(profile != "low-latency" && profile != "bulk-transfer") {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'profile'"));
+			}
+		}
+
+		/* limits of libcurl, a value of 0 keeps its default */
+		else if(setting.first == "buffer-size") {
+			if(hasBufferSize) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'buffer-size'."));
+			}
+			hasBufferSize = true;
+			bufferSize = utility::String::toNumber<decltype(bufferSize)>(setting.second);
+			if(bufferSize != 0 && (bufferSize < 1024 || bufferSize > CURL_MAX_READ_SIZE)) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(bufferSize) + "\" for attribute 'buffer-size'."));
+			}
+		}
+
+		else if(setting.first == "upload-buffer-size") {
+			if(hasUploadBufferSize) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'upload-buffer-size'."));
+			}
+			hasUploadBufferSize = true;
+			uploadBufferSize = utility::String::toNumber<decltype(uploadBufferSize)>(setting.second);
+			if(uploadBufferSize != 0 && (uploadBufferSize < 16 * 1024 || uploadBufferSize > 2 * 1024 * 1024)) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(uploadBufferSize) + "\" for attribute 'upload-buffer-size'."));
+			}
+		}
+
+		else if(setting.first == "tcp-nodelay") {
+			if(hasTcpNoDelay) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'tcp-nodelay'."));
+			}
+			hasTcpNoDelay = true;
+			std::string value = utility::String::toLower(setting.second);
+			if(value == "true") {
+				tcpNoDelay = true;
+			}
+			else if(value == "false") {
+				tcpNoDelay = false;
+			}
+			else {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'tcp-nodelay'"));
+			}
+		}
+
+		else if(setting.first == "tcp-keepalive-idle") {
+			if(hasTcpKeepAliveIdle) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'tcp-keepalive-idle'."));
+			}
+			hasTcpKeepAliveIdle = true;
+			tcpKeepAliveIdle = utility::String::toNumber<decltype(tcpKeepAliveIdle)>(setting.second);
+			if(tcpKeepAliveIdle < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(tcpKeepAliveIdle) + "\" for attribute 'tcp-keepalive-idle'."));
+			}
+		}
+
+		else if(setting.first == "tcp-keepalive-interval") {
+			if(hasTcpKeepAliveInterval) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'tcp-keepalive-interval'."));
+			}
+			hasTcpKeepAliveInterval = true;
+			tcpKeepAliveInterval = utility::String::toNumber<decltype(tcpKeepAliveInterval)>(setting.second);
+			if(tcpKeepAliveInterval < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(tcpKeepAliveInterval) + "\" for attribute 'tcp-keepalive-interval'."));
+			}
+		}
+
+		else if(setting.first == "connect-timeout-ms") {
+			if(hasConnectTimeoutMs) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'connect-timeout-ms'."));
+			}
+			hasConnectTimeoutMs = true;
+			connectTimeoutMs = utility::String::toNumber<decltype(connectTimeoutMs)>(setting.second);
+			if(connectTimeoutMs < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(connectTimeoutMs) + "\" for attribute 'connect-timeout-ms'."));
+			}
+		}
+
+		else if(setting.first == "expect-100-timeout-ms") {
+			if(hasExpect100TimeoutMs) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'expect-100-timeout-ms'."));
+			}
+			hasExpect100TimeoutMs = true;
+			expect100TimeoutMs = utility::String::toNumber<decltype(expect100TimeoutMs)>(setting.second);
+			if(expect100TimeoutMs < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(expect100TimeoutMs) + "\" for attribute 'expect-100-timeout-ms'."));
+			}
+		}
+
+		else if(setting.first == "timeout-ms") {
+			if(hasTimeoutMs) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'timeout-ms'."));
+			}
+			hasTimeoutMs = true;
+			timeoutMs = utility::String::toNumber<decltype(timeoutMs)>(setting.second);
+			if(timeoutMs < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(timeoutMs) + "\" for attribute 'timeout-ms'."));
+			}
+		}
+
+		else if(setting.first == "max-connects") {
+			if(hasMaxConnects) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'max-connects'."));
+			}
+			hasMaxConnects = true;
+			maxConnects = utility::String::toNumber<decltype(maxConnects)>(setting.second);
+			if(maxConnects < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(maxConnects) + "\" for attribute 'max-connects'."));
+			}
+		}
+
+		else if(setting.first == "ip-version") {
+			if(hasIpVersion) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'ip-version'."));
+			}
+			hasIpVersion = true;
+			std::string value = utility::String::toLower(setting.second);
+			if(value == "any") {
+				ipVersion = IpVersion::any;
+			}
+			else if(value == "4") {
+				ipVersion = IpVersion::ipv4;
+			}
+			else if(value == "6") {
+				ipVersion = IpVersion::ipv6;
+			}
+			else {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'ip-version'"));
+			}
+		}
+
+		else if(setting.first == "download-segments") {
+			if(hasDownloadSegments) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'download-segments'."));
+			}
+			hasDownloadSegments = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 1) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'download-segments'."));
+			}
+			downloadSegments = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "download-min-segment-size") {
+			if(hasDownloadMinSegmentSize) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'download-min-segment-size'."));
+			}
+			hasDownloadMinSegmentSize = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 1) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'download-min-segment-size'."));
+			}
+			downloadMinSegmentSize = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "download-segment-attempts") {
+			if(hasDownloadSegmentAttempts) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'download-segment-attempts'."));
+			}
+			hasDownloadSegmentAttempts = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 1) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'download-segment-attempts'."));
+			}
+			downloadSegmentAttempts = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "pipeline-depth") {
+			if(hasPipelineDepth) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'pipeline-depth'."));
+			}
+			hasPipelineDepth = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'pipeline-depth'."));
+			}
+			pipelineDepth = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "cache-size") {
+			if(hasCacheSize) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'cache-size'."));
+			}
+			hasCacheSize = true;
+			long value = utility::String::toNumber<long>(setting.second);
+			if(value < 0) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + std::to_string(value) + "\" for attribute 'cache-size'."));
+			}
+			cacheSize = static_cast<std::size_t>(value);
+		}
+
+		else if(setting.first == "metrics") {
+			if(hasMetrics) {
+	            throw system::Stacktrace::add(std::runtime_error("curl4esl: multiple definition of attribute 'metrics'."));
+			}
+			hasMetrics = true;
+			std::string value = utility::String::toLower(setting.second);
+			if(value == "true") {
+				metrics = true;
+			}
+			else if(value == "false") {
+				metrics = false;
+			}
+			else {
+		    	throw system::Stacktrace::add(std::runtime_error("curl4esl: Invalid value \"" + setting.second + "\" for attribute 'metrics'"));
+			}
+		}
+
 		else {
 			throw system::Stacktrace::add(std::runtime_error("Key \"" + setting.first + "\" is unknown"));
 		}
@@ -185,6 +776,50 @@ CURLConnectionFactory::Settings::Settings(const std::vector<std::pair<std::strin
 		hasLowSpeedDefinition = true;
 	}
 
+	if(profile == "low-latency") {
+		if(!hasConnectTimeoutMs) {
+			connectTimeoutMs = 1000;
+		}
+		if(!hasExpect100TimeoutMs) {
+			expect100TimeoutMs = 100;
+		}
+		if(!hasTcpKeepAliveIdle) {
+			tcpKeepAliveIdle = 10;
+		}
+		if(!hasTcpKeepAliveInterval) {
+			tcpKeepAliveInterval = 5;
+		}
+	}
+	else if(profile == "bulk-transfer") {
+		if(!hasBufferSize) {
+			bufferSize = 512 * 1024;
+		}
+		if(!hasUploadBufferSize) {
+			uploadBufferSize = 2 * 1024 * 1024;
+		}
+		if(!hasConnectTimeoutMs) {
+			connectTimeoutMs = 10000;
+		}
+		if(!hasTcpKeepAliveIdle) {
+			tcpKeepAliveIdle = 60;
+		}
+		if(!hasTcpKeepAliveInterval) {
+			tcpKeepAliveInterval = 30;
+		}
+	}
+
+	if(hasTimeout && hasTimeoutMs) {
+        throw system::Stacktrace::add(std::runtime_error("curl4esl: attributes 'timeout' and 'timeout-ms' must not be defined together."));
+	}
+
+	if(retryBaseBackoff > retryMaxBackoff) {
+        throw system::Stacktrace::add(std::runtime_error("curl4esl: value of attribute 'retry-base-backoff' is greater than value of attribute 'retry-max-backoff'."));
+	}
+
+	if(multiplex && httpVersion == HttpVersion::http1_1) {
+        throw system::Stacktrace::add(std::runtime_error("curl4esl: attribute 'multiplex' requires HTTP/2 but attribute 'http-version' is \"1.1\"."));
+	}
+
 	if(proxyServer.empty()) {
 		if(!proxyUsername.empty()) {
             throw system::Stacktrace::add(std::runtime_error("curl4esl: attribute 'proxy-username' specified but attribute 'proxy-server' is missing."));
@@ -26,6 +26,7 @@ SOFTWARE.
 #include <esl/com/http/client/Connection.h>
 #include <esl/com/http/client/ConnectionFactory.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
@@ -40,6 +41,19 @@ namespace client {
 class CURLConnectionFactory : public ConnectionFactory {
 public:
 	struct Settings {
+		enum class HttpVersion {
+			automatic,
+			http1_1,
+			http2,
+			http2PriorKnowledge
+		};
+
+		enum class IpVersion {
+			any,
+			ipv4,
+			ipv6
+		};
+
 		Settings() = default;
 		Settings(const std::vector<std::pair<std::string, std::string>>& settings);
 
@@ -59,11 +73,113 @@ public:
 		std::string userAgent = "esl-http-client";
 
 		bool skipSSLVerification = false;
+
+		/* Transport options, 0 keeps the default of libcurl.
+		 * Setting 'profile' sets a group of them, values defined explicitly take precedence:
+		 *   "low-latency":   connect timeout 1000 ms, 100-continue timeout 100 ms, keepalive probes after 10 s every 5 s.
+		 *                    Receive buffer (16 KiB) and TCP_NODELAY are the defaults already.
+		 *   "bulk-transfer": receive buffer 512 KiB, upload buffer 2 MiB, connect timeout 10000 ms, keepalive probes after 60 s every 30 s */
+		long bufferSize = 0;
+		long uploadBufferSize = 0;
+		bool tcpNoDelay = true;
+		/* seconds */
+		long tcpKeepAliveIdle = 0;
+		long tcpKeepAliveInterval = 0;
+		/* milliseconds, 'timeoutMs' must not be used together with 'timeout' */
+		long connectTimeoutMs = 0;
+		long timeoutMs = 0;
+		/* time to wait for "100 Continue" before a body is sent anyway, libcurl waits 1000 ms by default */
+		long expect100TimeoutMs = 0;
+		/* maximum number of connections kept open by a handle and by the event loop */
+		long maxConnects = 0;
+		IpVersion ipVersion = IpVersion::any;
+
+		/* maximum number of idle CURL handles kept for reuse, 0 disables pooling */
+		std::size_t poolMaxIdle = 16;
+		/* seconds after creation a handle is not reused anymore, 0 means unlimited */
+		long poolMaxLifetime = 0;
+		/* seconds a handle may stay idle before it gets evicted, 0 means unlimited */
+		long poolIdleTimeout = 60;
+
+		/* DNS cache and TLS sessions are always shared between all handles of a factory */
+		bool shareConnectionCache = false;
+
+		HttpVersion httpVersion = HttpVersion::automatic;
+
+		/* if enabled, all sends of a factory are multiplexed as HTTP/2 streams by its event loop */
+		bool multiplex = false;
+		long maxConcurrentStreams = 100;
+
+		/* Connections may be used by several threads at the same time, each thread gets its own handle.
+		 * Cookies are kept per thread. */
+		bool sharedConnection = false;
+
+		/* Seconds between background resolutions of the host of 'url', 0 resolves on demand by libcurl.
+		 * Sends use the latest addresses, so they do not wait for the resolver. Not used with a proxy. */
+		long dnsRefresh = 0;
+
+		/* default number of transfers of a batch that are running at the same time */
+		std::size_t batchConcurrency = 16;
+
+		/* Bytes buffered for a stalled writer before the transfer gets paused, 0 means unlimited.
+		 * The buffer may exceed this limit by at most one chunk received from libcurl. */
+		std::size_t maxReceiveBuffer = 0;
+
+		/* Milliseconds a writer may return 0 without taking any data, if the data queued for it cannot be
+		 * held back by pausing the transfer, e.g. because the transfer has finished already.
+		 * The send fails with CURLE_WRITE_ERROR then. 0 waits without limit. */
+		long writerStallTimeout = 30000;
+
+		/* Chunks queued for a writer that runs on a consumer thread of its own, 0 calls the writer on the
+		 * receiving thread. Only blocking sends on a connection of its own are pipelined. */
+		std::size_t pipelineDepth = 0;
+
+		/* Codings advertised by Accept-Encoding and decoded by libcurl while receiving, e.g. "gzip, br".
+		 * An empty list advertises all codings supported by libcurl. */
+		bool hasAcceptEncoding = false;
+		std::string acceptEncoding;
+
+		/* Attempts of a send including the first one, 1 disables retries. Only sends on a connection
+		 * of its own are retried, if their body can be sent again. Sends with a non-idempotent
+		 * method are only retried if there was no connection to the server. */
+		std::size_t retryMaxAttempts = 1;
+		/* milliseconds, the backoff doubles with every attempt up to 'retryMaxBackoff' */
+		long retryBaseBackoff = 100;
+		long retryMaxBackoff = 10000;
+		/* CURLcode values, default: COULDNT_RESOLVE_HOST, COULDNT_CONNECT, OPERATION_TIMEDOUT, GOT_NOTHING, SEND_ERROR and RECV_ERROR */
+		std::vector<int> retryCurlCodes = { 6, 7, 28, 52, 55, 56 };
+		/* responses of idempotent requests with these status codes are retried without passing them to 'createInput' or the input of the send */
+		std::vector<long> retryStatusCodes = { 502, 503, 504 };
+		/* percentage of requests within 10 seconds that may be retried, but at least 'retryBudgetMin' */
+		std::size_t retryBudget = 10;
+		std::size_t retryBudgetMin = 10;
+
+		/* GET requests without body are sent a second time, if the response has not started after
+		 * 'hedgeDelay' milliseconds or the 'hedgeDelayPercentile' of recent requests. 0 disables hedging. */
+		long hedgeDelay = 0;
+		std::size_t hedgeDelayPercentile = 0;
+		/* percentage of requests within 10 seconds that may be hedged */
+		std::size_t hedgeMaxRate = 5;
+
+		/* range requests running at the same time for a segmented download, each at least 'downloadMinSegmentSize' bytes */
+		std::size_t downloadSegments = 4;
+		std::size_t downloadMinSegmentSize = 1024 * 1024;
+		/* attempts of a segment, a failed segment is resumed at its current offset */
+		std::size_t downloadSegmentAttempts = 3;
+
+		/* bytes of the response cache shared by all connections of the factory, 0 disables caching */
+		std::size_t cacheSize = 0;
+
+		/* record request counters and latency histograms of all transfers */
+		bool metrics = true;
 	};
 
 	CURLConnectionFactory(const Settings& settings);
 
 	static std::unique_ptr<ConnectionFactory> create(const std::vector<std::pair<std::string, std::string>>& settings);
+	/* The extended API of curl4esl (asynchronous sends, batches, metrics, socket engines, ...) is available
+	 * by constructing a curl4esl::com::http::client::ConnectionFactory with these settings directly.
+	 * Its createNativeConnection() returns connections of type curl4esl::com::http::client::Connection. */
 	static std::unique_ptr<ConnectionFactory> createNative(const Settings& settings);
 
 	std::unique_ptr<Connection> createConnection() const override;
@@ -0,0 +1,636 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* Measures throughput and latency percentiles of typical workloads against a loopback HTTP/1.1 server.
+ * Scenarios ending with "-h2" run the same workload over HTTP/2 with TLS. The server also speaks h2c,
+ * but libcurl 7.88 fails to reuse a connection with prior knowledge, so it is not benchmarked.
+ * Scenarios named "header-parse" measure the parsing of response headers without any network,
+ * scenarios named "write-data-stalled" the queueing of received data for a stalled writer.
+ * Scenarios named "tls-new-handle" run against a TLS server and report its handshakes at the end,
+ * scenarios named "http2-multiplex" run against an HTTP/2 server over TLS and report its sockets at the end.
+ * The allocations per request are counted by the replaced global operator new, see Allocations.cpp.
+ *
+ * Usage: curl4esl-benchmark [filter [scale]]
+ *   filter: runs only the scenarios whose name contains it
+ *   scale:  factor for the number of requests of each scenario, e.g. 0.1 for a quick run */
+
+#include <benchmark/Allocations.h>
+
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/ReceiveBuffer.h>
+#include <curl4esl/com/http/client/Share.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Connection.h>
+#include <esl/com/http/client/CURLConnectionFactory.h>
+#include <esl/io/Input.h>
+#include <esl/io/Output.h>
+#include <esl/io/Writer.h>
+#include <esl/utility/String.h>
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using curl4esl::com::http::client::Connection;
+using curl4esl::com::http::client::ConnectionFactory;
+using curl4esl::com::http::client::HeaderStore;
+using curl4esl::com::http::client::LoopbackServer;
+using curl4esl::com::http::client::ReceiveBuffer;
+using curl4esl::com::http::client::Share;
+using curl4esl::com::http::client::TestUtility;
+
+using Settings = esl::com::http::client::CURLConnectionFactory::Settings;
+
+struct Scenario {
+	std::string name;
+	std::size_t requests;
+	/* performs a single request and returns the number of body bytes sent and received */
+	std::function<std::size_t (const ConnectionFactory& factory, Connection& connection)> run;
+	std::function<void (Settings& settings)> configure;
+	/* threads sending the requests on the same connection at the same time, 0 sends them on the calling thread */
+	std::size_t threads;
+};
+
+/* header lines of the "/headers" response as passed to CURLOPT_HEADERFUNCTION */
+std::vector<std::string> createHeaderLines() {
+	std::vector<std::string> lines;
+	lines.push_back("HTTP/1.1 200 OK\r\n");
+	lines.push_back("Content-Type: text/plain; charset=UTF-8\r\n");
+	lines.push_back("Content-Length: 64\r\n");
+	for(int i = 0; i < 100; ++i) {
+		lines.push_back("X-Header-" + std::to_string(i) + ": value of header number " + std::to_string(i) + "\r\n");
+	}
+	lines.push_back("Set-Cookie: a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT\r\n");
+	lines.push_back("Set-Cookie: b=2\r\n");
+	lines.push_back("\r\n");
+	return lines;
+}
+
+/* parser of curl4esl 1.6 before HeaderStore, kept as reference for "header-parse-legacy" */
+void parseLegacyHeader(std::map<std::string, std::string>& headers, const std::string& line) {
+	std::string header(line);
+	std::size_t seperator = header.find_first_of(":");
+
+	std::string key;
+	std::string value;
+
+	if(seperator == std::string::npos) {
+		key = esl::utility::String::trim(esl::utility::String::trim(esl::utility::String::trim(header), '\n'), '\r');
+	}
+	else {
+		key = esl::utility::String::trim(esl::utility::String::trim(esl::utility::String::trim(header.substr(0, seperator)), '\n'), '\r');
+		value = esl::utility::String::trim(esl::utility::String::trim(esl::utility::String::trim(header.substr(seperator + 1)), '\n'), '\r');
+	}
+
+	if(!key.empty()) {
+		headers[key] = value;
+	}
+}
+
+/* queue of Send::writeData of curl4esl 1.6 before ReceiveBuffer, kept as reference for "write-data-stalled-legacy".
+ * The writer of the benchmark never fails, so the error handling is left out. */
+class LegacyReceiveQueue {
+public:
+	std::size_t writeData(esl::io::Writer& writer, const std::uint8_t* data, const std::size_t size) {
+		while(receiveBuffer.empty() == false) {
+			Chunk& chunk = receiveBuffer.front();
+
+			std::size_t sizeRemaining = chunk.size() - currentPos;
+			std::size_t sizeWritten = writer.write(&chunk[currentPos], sizeRemaining);
+
+			if(sizeWritten == 0) {
+				receiveBuffer.push_back(Chunk(size));
+				std::memcpy(&receiveBuffer.back()[0], data, size);
+				return size;
+			}
+
+			currentPos += sizeWritten;
+			if(currentPos == chunk.size()) {
+				currentPos = 0;
+				receiveBuffer.pop_front();
+			}
+		}
+
+		currentPos = 0;
+		while(currentPos < size) {
+			std::size_t sizeWritten = writer.write(&data[currentPos], size - currentPos);
+			if(sizeWritten == 0) {
+				break;
+			}
+			currentPos += sizeWritten;
+		}
+
+		if(currentPos < size) {
+			std::size_t sizeRemaining = size - currentPos;
+			receiveBuffer.push_back(Chunk(sizeRemaining));
+			std::memcpy(&receiveBuffer.back()[0], &data[currentPos], sizeRemaining);
+			currentPos = 0;
+		}
+
+		return size;
+	}
+
+	void flush(esl::io::Writer& writer) {
+		while(receiveBuffer.empty() == false) {
+			Chunk& chunk = receiveBuffer.front();
+			currentPos += writer.write(&chunk[currentPos], chunk.size() - currentPos);
+			if(currentPos == chunk.size()) {
+				currentPos = 0;
+				receiveBuffer.pop_front();
+			}
+		}
+	}
+
+private:
+	using Chunk = std::vector<std::uint8_t>;
+	std::size_t currentPos = 0;
+	std::list<Chunk> receiveBuffer;
+};
+
+/* queue of Send::writeData with the ReceiveBuffer of the pooled handle */
+std::size_t writeData(ReceiveBuffer& receiveBuffer, esl::io::Writer& writer, const std::uint8_t* data, const std::size_t size) {
+	while(receiveBuffer.empty() == false) {
+		std::size_t sizeRemaining = 0;
+		const std::uint8_t* chunk = receiveBuffer.front(sizeRemaining);
+		std::size_t sizeWritten = writer.write(chunk, sizeRemaining);
+
+		if(sizeWritten == 0) {
+			receiveBuffer.append(data, size);
+			return size;
+		}
+
+		receiveBuffer.consume(sizeWritten);
+	}
+
+	std::size_t currentPos = 0;
+	while(currentPos < size) {
+		std::size_t sizeWritten = writer.write(&data[currentPos], size - currentPos);
+		if(sizeWritten == 0) {
+			break;
+		}
+		currentPos += sizeWritten;
+	}
+
+	receiveBuffer.append(&data[currentPos], size - currentPos);
+	return size;
+}
+
+void flush(ReceiveBuffer& receiveBuffer, esl::io::Writer& writer) {
+	while(receiveBuffer.empty() == false) {
+		std::size_t sizeRemaining = 0;
+		const std::uint8_t* chunk = receiveBuffer.front(sizeRemaining);
+		receiveBuffer.consume(writer.write(chunk, sizeRemaining));
+	}
+}
+
+std::size_t countBody(char*, std::size_t size, std::size_t nmemb, void* bytesPtr) {
+	*static_cast<std::size_t*>(bytesPtr) += size * nmemb;
+	return size * nmemb;
+}
+
+/* GET on a new easy handle, like each connection of curl4esl 1.6 before the handle pool, so every request needs a TLS handshake.
+ * It stays on HTTP/1.1, libcurl 7.88 resumes no TLS session of a closed HTTP/2 connection negotiated by ALPN. */
+std::size_t getOnNewHandle(const std::string& url, CURLSH* share) {
+	CURL* curl = curl_easy_init();
+	if(curl == nullptr) {
+		throw std::runtime_error("curl_easy_init failed");
+	}
+
+	std::size_t bytes = 0;
+	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+	curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+	curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+	curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_1_1));
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, countBody);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &bytes);
+	curl_easy_setopt(curl, CURLOPT_SHARE, share);
+	CURLcode rc = curl_easy_perform(curl);
+	curl_easy_cleanup(curl);
+
+	if(rc != CURLE_OK) {
+		throw std::runtime_error(std::string("curl_easy_perform failed: ") + curl_easy_strerror(rc));
+	}
+	return bytes;
+}
+
+double getPercentile(const std::vector<double>& sorted, double percentile) {
+	if(sorted.empty()) {
+		return 0;
+	}
+	std::size_t index = static_cast<std::size_t>(percentile / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void runScenario(const Scenario& scenario, const std::string& url, double scale) {
+	Settings settings = TestUtility::createSettings(url);
+	if(scenario.configure) {
+		scenario.configure(settings);
+	}
+	ConnectionFactory factory(settings);
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	std::size_t requests = std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(scenario.requests) * scale));
+
+	/* warm up connection and pool */
+	scenario.run(factory, connection);
+
+	std::size_t threadCount = std::max<std::size_t>(1, scenario.threads);
+	std::vector<std::vector<double>> threadLatencies(threadCount);
+	std::vector<std::size_t> threadBytes(threadCount, 0);
+
+	auto sendRequests = [&](std::size_t index) {
+		threadLatencies[index].reserve(requests / threadCount + 1);
+		for(std::size_t i = index; i < requests; i += threadCount) {
+			auto requestBegin = std::chrono::steady_clock::now();
+			threadBytes[index] += scenario.run(factory, connection);
+			threadLatencies[index].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - requestBegin).count());
+		}
+	};
+
+	std::uint64_t allocationsBegin = curl4esl::benchmark::getAllocations();
+	auto begin = std::chrono::steady_clock::now();
+	if(scenario.threads == 0) {
+		sendRequests(0);
+	}
+	else {
+		std::vector<std::thread> threads;
+		for(std::size_t i = 0; i < threadCount; ++i) {
+			threads.emplace_back(sendRequests, i);
+		}
+		for(auto& thread : threads) {
+			thread.join();
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	/* includes the allocations of the loopback server */
+	double allocationsPerRequest = static_cast<double>(curl4esl::benchmark::getAllocations() - allocationsBegin) / static_cast<double>(requests);
+
+	std::vector<double> latencies;
+	std::size_t bytes = 0;
+	for(std::size_t i = 0; i < threadCount; ++i) {
+		latencies.insert(latencies.end(), threadLatencies[i].begin(), threadLatencies[i].end());
+		bytes += threadBytes[i];
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << std::left << std::setw(36) << scenario.name << std::right
+			<< std::setw(8) << requests
+			<< std::setw(12) << std::fixed << std::setprecision(0) << static_cast<double>(requests) / seconds
+			<< std::setw(10) << std::setprecision(1) << static_cast<double>(bytes) / seconds / (1024 * 1024)
+			<< std::setw(10) << std::setprecision(0) << getPercentile(latencies, 50)
+			<< std::setw(10) << getPercentile(latencies, 90)
+			<< std::setw(10) << getPercentile(latencies, 99)
+			<< std::setw(10) << latencies.back()
+			<< std::setw(12) << std::setprecision(1) << allocationsPerRequest << std::endl;
+}
+}  // anonymer namespace
+
+int main(int argc, const char* argv[]) {
+	std::string filter = argc > 1 ? argv[1] : "";
+	double scale = argc > 2 ? std::atof(argv[2]) : 1.0;
+	if(scale <= 0) {
+		scale = 1.0;
+	}
+
+	const std::size_t largeSize = 16 * 1024 * 1024;
+	std::shared_ptr<const std::string> smallBody = std::make_shared<const std::string>(64, 'x');
+	std::shared_ptr<const std::string> largeBody = std::make_shared<const std::string>(largeSize, 'x');
+
+	auto handler = [&](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		if(request.path == "/large") {
+			response.sharedBody = largeBody;
+		}
+		else if(request.path == "/headers") {
+			for(int i = 0; i < 100; ++i) {
+				response.headers.emplace_back("X-Header-" + std::to_string(i), "value of header number " + std::to_string(i));
+			}
+			response.sharedBody = smallBody;
+		}
+		else if(request.path != "/upload") {
+			response.sharedBody = smallBody;
+		}
+		return response;
+	};
+	LoopbackServer server(handler);
+	server.setRecording(false);
+
+	/* the same responses over HTTP/2, negotiated by ALPN */
+	LoopbackServer h2Server(handler, LoopbackServer::Scheme::https);
+	h2Server.setRecording(false);
+	const std::string h2Url = h2Server.getUrl();
+
+	/* server that ignores "Expect: 100-continue", so the client sends the body after its timeout */
+	LoopbackServer silentServer;
+	silentServer.setRecording(false);
+	silentServer.setExpectContinue(false);
+	const std::string silentUrl = silentServer.getUrl();
+
+	/* a TLS server for each scenario comparing the share, so their handshakes are counted separately */
+	auto tlsHandler = [&smallBody](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		response.sharedBody = smallBody;
+		return response;
+	};
+	LoopbackServer tlsServer(tlsHandler, LoopbackServer::Scheme::https);
+	tlsServer.setRecording(false);
+	LoopbackServer tlsSharedServer(tlsHandler, LoopbackServer::Scheme::https);
+	tlsSharedServer.setRecording(false);
+
+	/* an HTTP/2 server for each scenario comparing multiplexing, so their sockets are counted separately.
+	 * The delay keeps the requests of all threads open at the same time. */
+	auto http2Handler = [&smallBody](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		response.sharedBody = smallBody;
+		response.delay = std::chrono::milliseconds(5);
+		return response;
+	};
+	LoopbackServer http2Server(http2Handler, LoopbackServer::Scheme::https);
+	http2Server.setRecording(false);
+	LoopbackServer http2MultiplexServer(http2Handler, LoopbackServer::Scheme::https);
+	http2MultiplexServer.setRecording(false);
+
+	std::vector<Scenario> scenarios;
+
+	scenarios.push_back(Scenario{"small-get", 5000, [](const ConnectionFactory&, Connection& connection) {
+		std::string body;
+		connection.send(TestUtility::createRequest("GET", "/small"), esl::io::Output(), TestUtility::createStringInput(body));
+		return body.size();
+	}, nullptr, 0});
+
+	scenarios.push_back(Scenario{"large-download", 50, [](const ConnectionFactory&, Connection& connection) {
+		std::size_t written = 0;
+		connection.send(TestUtility::createRequest("GET", "/large"), esl::io::Output(), [&written](const esl::com::http::client::Response&) {
+			return esl::io::Input(std::unique_ptr<esl::io::Writer>(new TestUtility::ThrottledWriter(written, static_cast<std::size_t>(-1), 0)));
+		});
+		return written;
+	}, nullptr, 0});
+
+	/* writer takes 4 KiB per call and stalls every third call, so received data queues up in the receive buffer */
+	scenarios.push_back(Scenario{"large-download-stalled", 50, [](const ConnectionFactory&, Connection& connection) {
+		std::size_t written = 0;
+		connection.send(TestUtility::createRequest("GET", "/large"), esl::io::Output(), [&written](const esl::com::http::client::Response&) {
+			return esl::io::Input(std::unique_ptr<esl::io::Writer>(new TestUtility::ThrottledWriter(written, 4096, 3)));
+		});
+		return written;
+	}, nullptr, 0});
+
+	/* body without size is sent chunked through the read callback */
+	scenarios.push_back(Scenario{"chunked-upload", 50, [largeSize](const ConnectionFactory&, Connection& connection) {
+		std::string body;
+		connection.send(TestUtility::createRequest("POST", "/upload"), TestUtility::createGeneratedOutput(largeSize, 64 * 1024), TestUtility::createStringInput(body));
+		return largeSize;
+	}, nullptr, 0});
+
+	scenarios.push_back(Scenario{"header-heavy", 5000, [](const ConnectionFactory&, Connection& connection) {
+		std::string body;
+		esl::com::http::client::Response response = connection.send(TestUtility::createRequest("GET", "/headers"), esl::io::Output(), TestUtility::createStringInput(body));
+		return body.size();
+	}, nullptr, 0});
+
+	/* profiles compared to the scenarios with default settings above */
+	auto addProfile = [&scenarios](const std::string& name, const std::string& profile) {
+		for(std::size_t i = 0; i < scenarios.size(); ++i) {
+			if(scenarios[i].name != name) {
+				continue;
+			}
+
+			/* settings of the profile as they are created from the configuration */
+			std::function<void (Settings& settings)> configure = scenarios[i].configure;
+			scenarios.push_back(Scenario{name + "-" + profile, scenarios[i].requests, scenarios[i].run, [configure, profile](Settings& settings) {
+				if(configure) {
+					configure(settings);
+				}
+				settings = Settings({ { "url", settings.url }, { "profile", profile } });
+			}, scenarios[i].threads});
+			return;
+		}
+	};
+	addProfile("small-get", "low-latency");
+	addProfile("large-download", "bulk-transfer");
+	addProfile("chunked-upload", "bulk-transfer");
+
+	/* HTTP/2 compared to the scenarios with HTTP/1.1 above */
+	auto addHttp2 = [&scenarios, h2Url](const std::string& name) {
+		for(std::size_t i = 0; i < scenarios.size(); ++i) {
+			if(scenarios[i].name != name) {
+				continue;
+			}
+
+			std::function<void (Settings& settings)> configure = scenarios[i].configure;
+			scenarios.push_back(Scenario{name + "-h2", scenarios[i].requests, scenarios[i].run, [configure, h2Url](Settings& settings) {
+				if(configure) {
+					configure(settings);
+				}
+				settings.url = h2Url;
+				settings.httpVersion = Settings::HttpVersion::http2;
+				settings.skipSSLVerification = true;
+			}, scenarios[i].threads});
+			return;
+		}
+	};
+	addHttp2("small-get");
+	addHttp2("large-download");
+	addHttp2("chunked-upload");
+	addHttp2("header-heavy");
+
+	/* libcurl announces bodies larger than 1 MiB with "Expect: 100-continue" */
+	auto uploadWithoutContinue = [](const ConnectionFactory&, Connection& connection) {
+		const std::size_t size = 2 * 1024 * 1024;
+		std::string body;
+		connection.send(TestUtility::createRequest("POST", "/upload"), TestUtility::createGeneratedOutput(size, 64 * 1024, true), TestUtility::createStringInput(body));
+		return size;
+	};
+	scenarios.push_back(Scenario{"upload-without-continue", 10, uploadWithoutContinue, [silentUrl](Settings& settings) {
+		settings.url = silentUrl;
+	}, 0});
+	addProfile("upload-without-continue", "low-latency");
+
+	/* small requests of several threads on one shared connection, each thread uses a handle of its own */
+	for(std::size_t threads : { 1, 2, 4, 8 }) {
+		scenarios.push_back(Scenario{"shared-connection-" + std::to_string(threads) + "-threads", 10000, [](const ConnectionFactory&, Connection& connection) {
+			std::string body;
+			connection.send(TestUtility::createRequest("GET", "/small"), esl::io::Output(), TestUtility::createStringInput(body));
+			return body.size();
+		}, [](Settings& settings) {
+			settings.sharedConnection = true;
+		}, threads});
+	}
+
+	/* a request is the parsing of all header lines of one response into the header map of the response */
+	const std::vector<std::string> headerLines = createHeaderLines();
+	std::size_t headerSize = 0;
+	for(const auto& line : headerLines) {
+		headerSize += line.size();
+	}
+
+	scenarios.push_back(Scenario{"header-parse-legacy", 20000, [&headerLines, headerSize](const ConnectionFactory&, Connection&) {
+		std::map<std::string, std::string> headers;
+		for(const auto& line : headerLines) {
+			parseLegacyHeader(headers, line);
+		}
+		return headerSize;
+	}, nullptr, 0});
+
+	/* the store is reused like by the pooled handles */
+	std::shared_ptr<HeaderStore> headerStore = std::make_shared<HeaderStore>();
+	scenarios.push_back(Scenario{"header-parse", 20000, [&headerLines, headerSize, headerStore](const ConnectionFactory&, Connection&) {
+		for(const auto& line : headerLines) {
+			headerStore->addLine(line.data(), line.size());
+		}
+		headerStore->toMap();
+		return headerSize;
+	}, nullptr, 0});
+
+	/* A request is the queueing of a 16 MiB body received in pieces of 16 KiB, the size of the callbacks of libcurl,
+	 * into a writer that takes 4 KiB per call and stalls every third call, like "large-download-stalled" without network. */
+	const std::vector<std::uint8_t> receivedData(16 * 1024, 'x');
+	scenarios.push_back(Scenario{"write-data-stalled-legacy", 50, [&receivedData, largeSize](const ConnectionFactory&, Connection&) {
+		std::size_t written = 0;
+		TestUtility::ThrottledWriter writer(written, 4096, 3);
+		LegacyReceiveQueue queue;
+		for(std::size_t received = 0; received < largeSize; received += receivedData.size()) {
+			queue.writeData(writer, receivedData.data(), receivedData.size());
+		}
+		queue.flush(writer);
+		return written;
+	}, nullptr, 0});
+
+	/* the buffer is reused by all requests like the one of a pooled handle */
+	std::shared_ptr<ReceiveBuffer> receiveBuffer = std::make_shared<ReceiveBuffer>();
+	scenarios.push_back(Scenario{"write-data-stalled", 50, [&receivedData, largeSize, receiveBuffer](const ConnectionFactory&, Connection&) {
+		std::size_t written = 0;
+		TestUtility::ThrottledWriter writer(written, 4096, 3);
+		for(std::size_t received = 0; received < largeSize; received += receivedData.size()) {
+			writeData(*receiveBuffer, writer, receivedData.data(), receivedData.size());
+		}
+		flush(*receiveBuffer, writer);
+		return written;
+	}, nullptr, 0});
+
+	/* every request on a new easy handle and TLS connection, the share lets the handle resume the TLS session of the previous one */
+	const std::string tlsUrl = tlsServer.getUrl() + "/small";
+	scenarios.push_back(Scenario{"tls-new-handle-without-share", 1000, [tlsUrl](const ConnectionFactory&, Connection&) {
+		return getOnNewHandle(tlsUrl, nullptr);
+	}, nullptr, 0});
+
+	const std::string tlsSharedUrl = tlsSharedServer.getUrl() + "/small";
+	std::shared_ptr<Share> share = std::make_shared<Share>(false);
+	scenarios.push_back(Scenario{"tls-new-handle-with-share", 1000, [tlsSharedUrl, share](const ConnectionFactory&, Connection&) {
+		return getOnNewHandle(tlsSharedUrl, share->get());
+	}, nullptr, 0});
+
+	/* small requests of 8 threads on one shared connection over HTTP/2, each thread on a socket of its own or all multiplexed on one */
+	for(bool multiplex : { false, true }) {
+		const std::string http2Url = (multiplex ? http2MultiplexServer : http2Server).getUrl();
+		scenarios.push_back(Scenario{std::string("http2-multiplex-") + (multiplex ? "on" : "off") + "-8-threads", 2000, [](const ConnectionFactory&, Connection& connection) {
+			std::string body;
+			connection.send(TestUtility::createRequest("GET", "/small"), esl::io::Output(), TestUtility::createStringInput(body));
+			return body.size();
+		}, [http2Url, multiplex](Settings& settings) {
+			settings.url = http2Url;
+			settings.httpVersion = Settings::HttpVersion::http2;
+			settings.skipSSLVerification = true;
+			settings.sharedConnection = true;
+			settings.multiplex = multiplex;
+		}, 8});
+	}
+
+	/* every request on a new connection object, the pooled handles keep their TCP connections */
+	scenarios.push_back(Scenario{"connection-churn", 5000, [](const ConnectionFactory& factory, Connection&) {
+		std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+		std::string body;
+		connection->send(TestUtility::createRequest("GET", "/small"), esl::io::Output(), TestUtility::createStringInput(body));
+		return body.size();
+	}, nullptr, 0});
+
+	/* every request on a new TCP connection */
+	scenarios.push_back(Scenario{"tcp-churn", 2000, [](const ConnectionFactory&, Connection& connection) {
+		std::string body;
+		curl4esl::com::http::client::PreparedRequest request = connection.prepare(TestUtility::createRequest("GET", "/small"));
+		connection.send(request, esl::io::Output(), TestUtility::createStringInput(body), { { "Connection", "close" } });
+		return body.size();
+	}, nullptr, 0});
+
+	std::cout << std::left << std::setw(36) << "scenario" << std::right
+			<< std::setw(8) << "count"
+			<< std::setw(12) << "req/s"
+			<< std::setw(10) << "MiB/s"
+			<< std::setw(10) << "p50 us"
+			<< std::setw(10) << "p90 us"
+			<< std::setw(10) << "p99 us"
+			<< std::setw(10) << "max us"
+			<< std::setw(12) << "allocs/req" << std::endl;
+
+	for(const auto& scenario : scenarios) {
+		if(scenario.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		try {
+			runScenario(scenario, server.getUrl(), scale);
+		}
+		catch(const std::exception& e) {
+			std::cout << std::left << std::setw(36) << scenario.name << "failed: " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	/* includes the handshake of the warm up request */
+	for(const auto& tls : { std::make_pair("tls-new-handle-without-share", &tlsServer), std::make_pair("tls-new-handle-with-share", &tlsSharedServer) }) {
+		if(tls.second->getHandshakes() > 0) {
+			std::cout << std::left << std::setw(36) << tls.first << std::right
+					<< tls.second->getHandshakes() << " TLS handshakes, "
+					<< tls.second->getResumedHandshakes() << " resumed" << std::endl;
+		}
+	}
+
+	for(const auto& http2 : { std::make_pair("http2-multiplex-off-8-threads", &http2Server), std::make_pair("http2-multiplex-on-8-threads", &http2MultiplexServer) }) {
+		if(http2.second->getConnections() > 0) {
+			std::cout << std::left << std::setw(36) << http2.first << std::right
+					<< http2.second->getConnections() << " sockets" << std::endl;
+		}
+	}
+
+	return 0;
+}
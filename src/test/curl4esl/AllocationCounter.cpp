@@ -0,0 +1,70 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/AllocationCounter.h>
+
+#include <cstdlib>
+#include <new>
+
+/* operator new and delete are replaced in a translation unit of their own,
+ * so the compiler does not see them inlined into the containers using them */
+namespace {
+thread_local bool counting = false;
+thread_local std::size_t allocations = 0;
+}  // anonymer namespace
+
+void* operator new(std::size_t size) {
+	if(counting) {
+		++allocations;
+	}
+
+	void* ptr = std::malloc(size > 0 ? size : 1);
+	if(ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace test {
+
+AllocationCounter::AllocationCounter() {
+	allocations = 0;
+	counting = true;
+}
+
+AllocationCounter::~AllocationCounter() {
+	counting = false;
+}
+
+std::size_t AllocationCounter::get() const noexcept {
+	return allocations;
+}
+
+} /* namespace test */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,87 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <utility>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace test {
+
+Failure::Failure(const char* file, int line, const std::string& message)
+: std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": " + message)
+{ }
+
+std::vector<TestCase>& getTestCases() {
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+Registration::Registration(const char* name, std::function<void ()> function) {
+	getTestCases().push_back(TestCase{name, std::move(function)});
+}
+
+std::size_t run(const std::string& filter) {
+	std::size_t executed = 0;
+	std::size_t failed = 0;
+
+	for(const auto& testCase : getTestCases()) {
+		if(testCase.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		++executed;
+
+		std::cout << "[ RUN      ] " << testCase.name << std::endl;
+		auto begin = std::chrono::steady_clock::now();
+		bool passed = false;
+		try {
+			testCase.function();
+			passed = true;
+		}
+		catch(const std::exception& e) {
+			std::cout << e.what() << std::endl;
+		}
+		catch(...) {
+			std::cout << "unknown exception" << std::endl;
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+
+		if(passed) {
+			std::cout << "[       OK ] " << testCase.name << " (" << duration << " ms)" << std::endl;
+		}
+		else {
+			++failed;
+			std::cout << "[  FAILED  ] " << testCase.name << " (" << duration << " ms)" << std::endl;
+		}
+	}
+
+	std::cout << executed - failed << " of " << executed << " tests passed" << std::endl;
+	return failed;
+}
+
+} /* namespace test */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,89 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_TEST_H_
+#define CURL4ESL_TEST_H_
+
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace test {
+
+/* Minimal test registry, so the tests need nothing but the library itself.
+ * A test is a function that throws Failure if a check does not hold. */
+class Failure : public std::runtime_error {
+public:
+	Failure(const char* file, int line, const std::string& message);
+};
+
+struct TestCase {
+	std::string name;
+	std::function<void ()> function;
+};
+
+std::vector<TestCase>& getTestCases();
+
+class Registration {
+public:
+	Registration(const char* name, std::function<void ()> function);
+};
+
+/* runs all tests whose name contains 'filter', returns the number of failed tests */
+std::size_t run(const std::string& filter);
+
+} /* namespace test */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#define CURL4ESL_TEST_CONCAT2(a, b) a##b
+#define CURL4ESL_TEST_CONCAT(a, b) CURL4ESL_TEST_CONCAT2(a, b)
+
+#define CURL4ESL_TEST(name) \
+	static void name(); \
+	static ::curl4esl::test::Registration CURL4ESL_TEST_CONCAT(name, Registration)(#name, name); \
+	static void name()
+
+#define CURL4ESL_CHECK(expression) \
+	do { \
+		if(!(expression)) { \
+			throw ::curl4esl::test::Failure(__FILE__, __LINE__, "check failed: " #expression); \
+		} \
+	} while(false)
+
+#define CURL4ESL_CHECK_EQUAL(expected, actual) \
+	do { \
+		const auto& curl4eslExpected = (expected); \
+		const auto& curl4eslActual = (actual); \
+		if(!(curl4eslExpected == curl4eslActual)) { \
+			std::ostringstream curl4eslStream; \
+			curl4eslStream << "check failed: " #expected " == " #actual " (" << curl4eslExpected << " != " << curl4eslActual << ")"; \
+			throw ::curl4esl::test::Failure(__FILE__, __LINE__, curl4eslStream.str()); \
+		} \
+	} while(false)
+
+#endif /* CURL4ESL_TEST_H_ */
@@ -0,0 +1,369 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Output.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+CURL4ESL_TEST(connectionSendsGet) {
+	LoopbackServer server([](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		response.headers.emplace_back("Content-Type", "text/plain");
+		response.body = "hello";
+		return response;
+	});
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/hello"), esl::io::Output(), TestUtility::createStringInput(body));
+
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(std::string("hello"), body);
+	CURL4ESL_CHECK_EQUAL(std::string("text/plain"), response.getContentType().toString());
+
+	auto requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(1u, requests.size());
+	CURL4ESL_CHECK_EQUAL(std::string("GET"), requests[0].method);
+	CURL4ESL_CHECK_EQUAL(std::string("/hello"), requests[0].path);
+}
+
+CURL4ESL_TEST(connectionSendsChunkedBody) {
+	LoopbackServer server;
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	connection->send(TestUtility::createRequest("POST", "/upload"), TestUtility::createGeneratedOutput(100000, 4096), TestUtility::createStringInput(body));
+
+	auto requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(1u, requests.size());
+	CURL4ESL_CHECK(requests[0].chunked);
+	CURL4ESL_CHECK_EQUAL(100000u, requests[0].body.size());
+}
+
+CURL4ESL_TEST(connectionsReusePooledHandles) {
+	LoopbackServer server;
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+
+	for(int i = 0; i < 3; ++i) {
+		std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+		std::string body;
+		connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+	}
+
+	/* the pooled handle keeps its connection to the server */
+	CURL4ESL_CHECK_EQUAL(1u, server.getConnections());
+	CURL4ESL_CHECK_EQUAL(2u, factory.getHandlePoolStatistics().hits);
+}
+
+CURL4ESL_TEST(sharedConnectionReleasesHandlesOfAllThreads) {
+	LoopbackServer server;
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.sharedConnection = true;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::size_t sent = 0;
+	bool destroyed = false;
+
+	/* threads keep running until the connection has been destroyed */
+	std::vector<std::thread> threads;
+	for(int i = 0; i < 3; ++i) {
+		threads.emplace_back([&] {
+			std::string body;
+			connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+
+			std::unique_lock<std::mutex> lock(mutex);
+			++sent;
+			condition.notify_all();
+			condition.wait(lock, [&] { return destroyed; });
+		});
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [&] { return sent == 3; });
+	}
+	CURL4ESL_CHECK_EQUAL(0u, factory.getHandlePoolStatistics().idle);
+
+	connection.reset();
+	CURL4ESL_CHECK_EQUAL(3u, factory.getHandlePoolStatistics().idle);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		destroyed = true;
+		condition.notify_all();
+	}
+	for(auto& thread : threads) {
+		thread.join();
+	}
+	CURL4ESL_CHECK_EQUAL(3u, factory.getHandlePoolStatistics().idle);
+}
+
+CURL4ESL_TEST(sharedConnectionSendsOfTwoThreadsAtTheSameTime) {
+	/* the first request of each thread is answered when both have arrived, so they are in flight at the same time */
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::size_t arrived = 0;
+	bool overlapped = false;
+	LoopbackServer server([&](const LoopbackServer::Request& request) {
+		if(request.path.compare(request.path.size() - 2, 2, "/0") == 0) {
+			std::unique_lock<std::mutex> lock(mutex);
+			++arrived;
+			condition.notify_all();
+			if(condition.wait_for(lock, std::chrono::seconds(5), [&] { return arrived == 2; })) {
+				overlapped = true;
+			}
+		}
+
+		LoopbackServer::Response response;
+		response.body = request.path;
+		return response;
+	});
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.sharedConnection = true;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	const std::size_t requests = 50;
+	std::vector<std::size_t> failures(2, 0);
+	std::vector<std::thread> threads;
+	for(std::size_t t = 0; t < 2; ++t) {
+		threads.emplace_back([&connection, &failures, t, requests] {
+			for(std::size_t i = 0; i < requests; ++i) {
+				std::string path = "/thread" + std::to_string(t) + "/" + std::to_string(i);
+				std::string body;
+				esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", path), esl::io::Output(), TestUtility::createStringInput(body));
+				if(response.getStatusCode() != 200 || body != path) {
+					++failures[t];
+				}
+			}
+		});
+	}
+	for(auto& thread : threads) {
+		thread.join();
+	}
+
+	CURL4ESL_CHECK(overlapped);
+	CURL4ESL_CHECK_EQUAL(0u, failures[0]);
+	CURL4ESL_CHECK_EQUAL(0u, failures[1]);
+
+	/* each thread has sent all of its requests on the TCP connection of its own handle */
+	std::vector<LoopbackServer::Request> received = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(2 * requests, received.size());
+	std::size_t connections[2] = { 0, 0 };
+	for(const auto& request : received) {
+		std::size_t t = request.path.compare(0, 8, "/thread0") == 0 ? 0 : 1;
+		if(connections[t] == 0) {
+			connections[t] = request.connection;
+		}
+		CURL4ESL_CHECK_EQUAL(connections[t], request.connection);
+	}
+	CURL4ESL_CHECK(connections[0] != connections[1]);
+
+	/* both handles have been released when their threads exited */
+	CURL4ESL_CHECK_EQUAL(2u, factory.getHandlePoolStatistics().idle);
+}
+
+CURL4ESL_TEST(sharedConnectionReleasesHandleOfExitedThread) {
+	LoopbackServer server;
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.sharedConnection = true;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::thread thread([&connection] {
+		std::string body;
+		connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+	});
+	thread.join();
+
+	CURL4ESL_CHECK_EQUAL(1u, factory.getHandlePoolStatistics().idle);
+}
+
+/* HTTP/2 over TLS, libcurl 7.88 fails to reuse connections with prior knowledge (h2c) */
+esl::com::http::client::CURLConnectionFactory::Settings createHttp2Settings(const LoopbackServer& server) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.httpVersion = esl::com::http::client::CURLConnectionFactory::Settings::HttpVersion::http2;
+	settings.skipSSLVerification = true;
+	return settings;
+}
+
+CURL4ESL_TEST(multiplexedSendsShareOneHttp2Connection) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.body = request.path;
+		/* keeps the streams of all threads open at the same time */
+		response.delay = std::chrono::milliseconds(20);
+		return response;
+	}, LoopbackServer::Scheme::https);
+	esl::com::http::client::CURLConnectionFactory::Settings settings = createHttp2Settings(server);
+	settings.multiplex = true;
+	ConnectionFactory factory(settings);
+
+	const std::size_t threadCount = 8;
+	std::vector<std::size_t> failures(threadCount, 0);
+	std::vector<std::thread> threads;
+	for(std::size_t t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&factory, &failures, t] {
+			std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+			for(int i = 0; i < 5; ++i) {
+				const std::string path = "/thread" + std::to_string(t) + "/" + std::to_string(i);
+				std::string body;
+				try {
+					esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", path), esl::io::Output(), TestUtility::createStringInput(body));
+					if(response.getStatusCode() != 200 || body != path) {
+						++failures[t];
+					}
+				}
+				catch(...) {
+					++failures[t];
+				}
+			}
+		});
+	}
+	for(auto& thread : threads) {
+		thread.join();
+	}
+
+	for(std::size_t t = 0; t < threadCount; ++t) {
+		CURL4ESL_CHECK_EQUAL(0u, failures[t]);
+	}
+	CURL4ESL_CHECK_EQUAL(threadCount * 5, server.getRequests().size());
+	CURL4ESL_CHECK_EQUAL(1u, server.getConnections());
+}
+
+CURL4ESL_TEST(http2TransfersBodiesLargerThanWindow) {
+	const std::size_t size = 1024 * 1024;
+	std::shared_ptr<const std::string> largeBody = std::make_shared<const std::string>(size, 'x');
+	LoopbackServer server([largeBody](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		if(request.method == "POST") {
+			response.body = std::to_string(request.body.size());
+		}
+		else {
+			response.sharedBody = largeBody;
+		}
+		return response;
+	}, LoopbackServer::Scheme::https);
+	ConnectionFactory factory(createHttp2Settings(server));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	connection->send(TestUtility::createRequest("POST", "/upload"), TestUtility::createGeneratedOutput(size, 64 * 1024, true), TestUtility::createStringInput(body));
+	CURL4ESL_CHECK_EQUAL(std::to_string(size), body);
+
+	body.clear();
+	connection->send(TestUtility::createRequest("GET", "/download"), esl::io::Output(), TestUtility::createStringInput(body));
+	CURL4ESL_CHECK_EQUAL(size, body.size());
+	CURL4ESL_CHECK_EQUAL(1u, server.getConnections());
+}
+
+CURL4ESL_TEST(http2WithPriorKnowledge) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.body = request.path;
+		return response;
+	});
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.httpVersion = esl::com::http::client::CURLConnectionFactory::Settings::HttpVersion::http2PriorKnowledge;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/h2c"), esl::io::Output(), TestUtility::createStringInput(body));
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL("/h2c", body);
+}
+
+CURL4ESL_TEST(sendBatchCompletesAllRequestsInOrder) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.body = request.path;
+		return response;
+	});
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	/* batches are sent repeatedly, so completions that run while sendBatch returns overlap with the next batch */
+	for(int batch = 0; batch < 20; ++batch) {
+		std::vector<esl::com::http::client::Request> requests;
+		for(int i = 0; i < 50; ++i) {
+			requests.push_back(TestUtility::createRequest("GET", "/" + std::to_string(i)));
+		}
+
+		std::vector<std::string> bodies(requests.size());
+		std::vector<Connection::BatchRequest> batchRequests;
+		for(std::size_t i = 0; i < requests.size(); ++i) {
+			batchRequests.emplace_back(requests[i], esl::io::Output(), TestUtility::createStringInput(bodies[i]));
+		}
+
+		std::vector<Connection::BatchResult> results = connection.sendBatch(std::move(batchRequests), 4);
+
+		CURL4ESL_CHECK_EQUAL(requests.size(), results.size());
+		for(std::size_t i = 0; i < results.size(); ++i) {
+			CURL4ESL_CHECK(results[i].response != nullptr);
+			CURL4ESL_CHECK_EQUAL("/" + std::to_string(i), bodies[i]);
+		}
+	}
+}
+
+CURL4ESL_TEST(sendBatchWithoutRequests) {
+	LoopbackServer server;
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	CURL4ESL_CHECK(connection.sendBatch(std::vector<Connection::BatchRequest>(), 4).empty());
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
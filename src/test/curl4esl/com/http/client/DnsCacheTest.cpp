@@ -0,0 +1,142 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/DnsCache.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/MultiEngine.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Response.h>
+#include <esl/com/http/client/exception/NetworkError.h>
+#include <esl/io/Output.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* "localhost" is resolved by the hosts file, so the tests do not depend on a name server */
+esl::com::http::client::CURLConnectionFactory::Settings createDnsSettings(const LoopbackServer& server) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings("http://localhost:" + std::to_string(server.getPort()));
+	settings.dnsRefresh = 60;
+	/* the loopback server listens on IPv4 only */
+	settings.ipVersion = esl::com::http::client::CURLConnectionFactory::Settings::IpVersion::ipv4;
+	return settings;
+}
+
+std::shared_ptr<const DnsCache::ResolveList> waitForResolveList(const DnsCache& dnsCache) {
+	for(int i = 0; i < 200; ++i) {
+		std::shared_ptr<const DnsCache::ResolveList> resolveList = dnsCache.getResolveList();
+		if(resolveList) {
+			return resolveList;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return nullptr;
+}
+
+CURL4ESL_TEST(dnsCacheResolvesHostOfUrl) {
+	LoopbackServer server;
+	esl::com::http::client::CURLConnectionFactory::Settings settings = createDnsSettings(server);
+	DnsCache dnsCache(settings);
+	CURL4ESL_CHECK(dnsCache.isEnabled());
+
+	std::shared_ptr<const DnsCache::ResolveList> resolveList = waitForResolveList(dnsCache);
+	CURL4ESL_CHECK(resolveList != nullptr);
+	CURL4ESL_CHECK_EQUAL("localhost:" + std::to_string(server.getPort()) + ":127.0.0.1", std::string(resolveList->get()->data));
+	CURL4ESL_CHECK(resolveList->get()->next == nullptr);
+}
+
+CURL4ESL_TEST(dnsCacheIsNotUsedForAddresses) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings("http://127.0.0.1:8080");
+	settings.dnsRefresh = 60;
+	DnsCache dnsCache(settings);
+
+	CURL4ESL_CHECK(!dnsCache.isEnabled());
+	CURL4ESL_CHECK(dnsCache.getResolveList() == nullptr);
+}
+
+CURL4ESL_TEST(sendUsesResolvedAddress) {
+	LoopbackServer server;
+	/* ".test" is reserved (RFC 2606), so libcurl cannot resolve the host by itself
+	 * and the send reaches the server only if it uses the addresses of the DNS cache */
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings("http://curl4esl.test:" + std::to_string(server.getPort()));
+	settings.dnsRefresh = 60;
+	DnsCache::Resolver resolver = [](const std::string& host, const std::string&, esl::com::http::client::CURLConnectionFactory::Settings::IpVersion) {
+		return host == "curl4esl.test" ? std::string("127.0.0.1") : std::string();
+	};
+	std::shared_ptr<HandlePool> handlePool = std::make_shared<HandlePool>(settings, resolver);
+	std::shared_ptr<MultiEngine> multiEngine = std::make_shared<MultiEngine>(false, settings.maxConcurrentStreams, settings.maxConnects);
+	Connection connection(handlePool, multiEngine, settings.url, false);
+
+	std::shared_ptr<const DnsCache::ResolveList> resolveList = waitForResolveList(handlePool->getDnsCache());
+	CURL4ESL_CHECK(resolveList != nullptr);
+	CURL4ESL_CHECK_EQUAL("curl4esl.test:" + std::to_string(server.getPort()) + ":127.0.0.1", std::string(resolveList->get()->data));
+
+	for(int i = 0; i < 3; ++i) {
+		std::string body;
+		esl::com::http::client::Response response = connection.send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+		CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	}
+	CURL4ESL_CHECK_EQUAL(1u, server.getConnections());
+}
+
+CURL4ESL_TEST(sendFailsWithoutResolvedAddress) {
+	LoopbackServer server;
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings("http://curl4esl.test:" + std::to_string(server.getPort()));
+	/* the same stub, but the DNS cache is disabled, so libcurl resolves the host by itself */
+	settings.dnsRefresh = 0;
+	DnsCache::Resolver resolver = [](const std::string&, const std::string&, esl::com::http::client::CURLConnectionFactory::Settings::IpVersion) {
+		return std::string("127.0.0.1");
+	};
+	std::shared_ptr<HandlePool> handlePool = std::make_shared<HandlePool>(settings, resolver);
+	std::shared_ptr<MultiEngine> multiEngine = std::make_shared<MultiEngine>(false, settings.maxConcurrentStreams, settings.maxConnects);
+	Connection connection(handlePool, multiEngine, settings.url, false);
+
+	CURL4ESL_CHECK(!handlePool->getDnsCache().isEnabled());
+	bool failed = false;
+	try {
+		connection.send(TestUtility::createRequest("GET", "/"), esl::io::Output(), esl::io::Input());
+	}
+	catch(const esl::com::http::client::exception::NetworkError& e) {
+		failed = std::string(e.what()).find("=" + std::to_string(CURLE_COULDNT_RESOLVE_HOST) + " ") != std::string::npos;
+	}
+	CURL4ESL_CHECK(failed);
+	CURL4ESL_CHECK_EQUAL(0u, server.getConnections());
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,64 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <memory>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+CURL4ESL_TEST(handlesReleasedToFullPoolAreEvicted) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings("http://127.0.0.1");
+	settings.poolMaxIdle = 1;
+	std::shared_ptr<HandlePool> handlePool = std::make_shared<HandlePool>(settings);
+
+	{
+		HandlePool::HandlePtr first = handlePool->acquire();
+		HandlePool::HandlePtr second = handlePool->acquire();
+		HandlePool::HandlePtr third = handlePool->acquire();
+	}
+
+	HandlePool::Statistics statistics = handlePool->getStatistics();
+	CURL4ESL_CHECK_EQUAL(3u, statistics.misses);
+	CURL4ESL_CHECK_EQUAL(1u, statistics.idle);
+	CURL4ESL_CHECK_EQUAL(2u, statistics.evictions);
+
+	/* the idle handle is reused */
+	handlePool->acquire();
+	statistics = handlePool->getStatistics();
+	CURL4ESL_CHECK_EQUAL(1u, statistics.hits);
+	CURL4ESL_CHECK_EQUAL(2u, statistics.evictions);
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
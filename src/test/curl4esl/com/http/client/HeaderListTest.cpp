@@ -0,0 +1,93 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/AllocationCounter.h>
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/HeaderList.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Request.h>
+
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+const std::string longValue(100, 'v');
+
+CURL4ESL_TEST(reusedHeaderListDoesNotAllocate) {
+	const std::string keys[] = { "Accept", "Authorization", "X-Request-Id" };
+	HeaderList headerList;
+
+	for(int i = 0; i < 10; ++i) {
+		test::AllocationCounter allocationCounter;
+		headerList.clear();
+		for(const auto& key : keys) {
+			headerList.add(key, longValue);
+		}
+
+		if(i == 0) {
+			CURL4ESL_CHECK(allocationCounter.get() > 0);
+		}
+		else {
+			CURL4ESL_CHECK_EQUAL(0u, allocationCounter.get());
+		}
+	}
+
+	std::size_t count = 0;
+	for(curl_slist* header = headerList.getHead(); header; header = header->next) {
+		CURL4ESL_CHECK_EQUAL(keys[count] + ": " + longValue, std::string(header->data));
+		++count;
+	}
+	CURL4ESL_CHECK_EQUAL(3u, count);
+}
+
+CURL4ESL_TEST(reassignedPreparedRequestDoesNotAllocate) {
+	esl::com::http::client::Request request = TestUtility::createRequest("GET", "/some/rather/long/path/of/a/resource");
+	request.addHeader("Accept", longValue);
+	request.addHeader("X-Request-Id", longValue);
+	const std::string hostUrl = "http://127.0.0.1:8080";
+
+	PreparedRequest preparedRequest(hostUrl, request);
+	for(int i = 0; i < 10; ++i) {
+		test::AllocationCounter allocationCounter;
+		preparedRequest.assign(hostUrl, request);
+		CURL4ESL_CHECK_EQUAL(0u, allocationCounter.get());
+	}
+
+	CURL4ESL_CHECK_EQUAL(hostUrl + "/some/rather/long/path/of/a/resource", preparedRequest.getUrl());
+	std::string value;
+	CURL4ESL_CHECK(preparedRequest.findHeader("X-Request-Id", value));
+	CURL4ESL_CHECK_EQUAL(longValue, value);
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,95 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+void add(HeaderStore& store, const std::string& key, const std::string& value) {
+	store.add(key.data(), key.size(), value.data(), value.size());
+}
+
+CURL4ESL_TEST(headerStoreFindsCaseInsensitive) {
+	HeaderStore store;
+	add(store, "content-type", "text/plain");
+
+	CURL4ESL_CHECK(store.find("Content-Type") != nullptr);
+	CURL4ESL_CHECK_EQUAL(std::string("text/plain"), *store.find("CONTENT-TYPE"));
+	CURL4ESL_CHECK(store.find("Content-Length") == nullptr);
+}
+
+CURL4ESL_TEST(headerStoreCombinesDuplicateFields) {
+	HeaderStore store;
+	add(store, "Cache-Control", "no-cache");
+	add(store, "Cache-Control", "no-store");
+
+	std::map<std::string, std::string> headers = store.toMap();
+	CURL4ESL_CHECK_EQUAL(std::string("no-cache, no-store"), headers["Cache-Control"]);
+}
+
+CURL4ESL_TEST(headerStoreDoesNotCombineSetCookie) {
+	HeaderStore store;
+	add(store, "Set-Cookie", "a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT");
+	add(store, "Set-Cookie", "b=2");
+
+	/* both fields are kept in the store */
+	CURL4ESL_CHECK_EQUAL(2u, store.size());
+
+	/* the map gets all values, as they may contain commas they are separated by newlines */
+	std::map<std::string, std::string> headers = store.toMap();
+	CURL4ESL_CHECK_EQUAL(1u, headers.size());
+	CURL4ESL_CHECK_EQUAL(std::string("a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT\nb=2"), headers.begin()->second);
+
+	std::vector<std::string> values = HeaderStore::splitSetCookie(headers.begin()->second);
+	CURL4ESL_CHECK_EQUAL(2u, values.size());
+	CURL4ESL_CHECK_EQUAL(std::string("a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT"), values[0]);
+	CURL4ESL_CHECK_EQUAL(std::string("b=2"), values[1]);
+}
+
+CURL4ESL_TEST(headerStoreReusesClearedEntries) {
+	HeaderStore store;
+	add(store, "A", "1");
+	add(store, "B", "2");
+	store.clear();
+	add(store, "C", "3");
+
+	CURL4ESL_CHECK_EQUAL(1u, store.size());
+	CURL4ESL_CHECK(store.find("A") == nullptr);
+	CURL4ESL_CHECK_EQUAL(std::string("3"), *store.find("C"));
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
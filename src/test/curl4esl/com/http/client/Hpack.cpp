@@ -0,0 +1,360 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/Hpack.h>
+
+#include <cctype>
+#include <cstdint>
+#include <unordered_map>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* static table (RFC 7541, appendix A), index 1 is the first entry */
+const std::pair<const char*, const char*> staticTable[] = {
+	{ ":authority", "" },
+	{ ":method", "GET" },
+	{ ":method", "POST" },
+	{ ":path", "/" },
+	{ ":path", "/index.html" },
+	{ ":scheme", "http" },
+	{ ":scheme", "https" },
+	{ ":status", "200" },
+	{ ":status", "204" },
+	{ ":status", "206" },
+	{ ":status", "304" },
+	{ ":status", "400" },
+	{ ":status", "404" },
+	{ ":status", "500" },
+	{ "accept-charset", "" },
+	{ "accept-encoding", "gzip, deflate" },
+	{ "accept-language", "" },
+	{ "accept-ranges", "" },
+	{ "accept", "" },
+	{ "access-control-allow-origin", "" },
+	{ "age", "" },
+	{ "allow", "" },
+	{ "authorization", "" },
+	{ "cache-control", "" },
+	{ "content-disposition", "" },
+	{ "content-encoding", "" },
+	{ "content-language", "" },
+	{ "content-length", "" },
+	{ "content-location", "" },
+	{ "content-range", "" },
+	{ "content-type", "" },
+	{ "cookie", "" },
+	{ "date", "" },
+	{ "etag", "" },
+	{ "expect", "" },
+	{ "expires", "" },
+	{ "from", "" },
+	{ "host", "" },
+	{ "if-match", "" },
+	{ "if-modified-since", "" },
+	{ "if-none-match", "" },
+	{ "if-range", "" },
+	{ "if-unmodified-since", "" },
+	{ "last-modified", "" },
+	{ "link", "" },
+	{ "location", "" },
+	{ "max-forwards", "" },
+	{ "proxy-authenticate", "" },
+	{ "proxy-authorization", "" },
+	{ "range", "" },
+	{ "referer", "" },
+	{ "refresh", "" },
+	{ "retry-after", "" },
+	{ "server", "" },
+	{ "set-cookie", "" },
+	{ "strict-transport-security", "" },
+	{ "transfer-encoding", "" },
+	{ "user-agent", "" },
+	{ "vary", "" },
+	{ "via", "" },
+	{ "www-authenticate", "" },
+};
+constexpr std::size_t staticTableSize = sizeof(staticTable) / sizeof(staticTable[0]);
+
+struct HuffmanCode {
+	std::uint32_t code;
+	unsigned length;
+};
+
+/* Huffman code of each octet (RFC 7541, appendix B), the code of EOS has 30 bits and is never decoded */
+const HuffmanCode huffmanCodes[256] = {
+	{ 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 }, { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+	{ 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 }, { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+	{ 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 }, { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+	{ 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 }, { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+	{ 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 }, { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+	{ 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 }, { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+	{ 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 }, { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+	{ 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 }, { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+	{ 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 }, { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+	{ 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 }, { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+	{ 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 }, { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+	{ 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 }, { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+	{ 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 }, { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+	{ 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 }, { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+	{ 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 }, { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+	{ 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 }, { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+	{ 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 }, { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+	{ 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 }, { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+	{ 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 }, { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+	{ 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 }, { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+	{ 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 }, { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+	{ 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 }, { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+	{ 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 }, { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+	{ 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 }, { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+	{ 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 }, { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+	{ 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 }, { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+	{ 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 }, { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+	{ 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 }, { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+	{ 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 }, { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+	{ 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 }, { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+	{ 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 }, { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+	{ 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 }, { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+};
+
+/* symbol by code, the key is the length of the code in the upper 32 bits and the code in the lower ones */
+const std::unordered_map<std::uint64_t, unsigned char>& getHuffmanSymbols() {
+	static const std::unordered_map<std::uint64_t, unsigned char> symbols = [] {
+		std::unordered_map<std::uint64_t, unsigned char> result;
+		for(unsigned symbol = 0; symbol < 256; ++symbol) {
+			result[(static_cast<std::uint64_t>(huffmanCodes[symbol].length) << 32) | huffmanCodes[symbol].code] = static_cast<unsigned char>(symbol);
+		}
+		return result;
+	}();
+	return symbols;
+}
+
+bool decodeHuffman(const std::string& data, std::string& result) {
+	const std::unordered_map<std::uint64_t, unsigned char>& symbols = getHuffmanSymbols();
+
+	std::uint32_t code = 0;
+	unsigned length = 0;
+	for(unsigned char octet : data) {
+		for(int bit = 7; bit >= 0; --bit) {
+			code = (code << 1) | ((octet >> bit) & 1);
+			++length;
+			/* the shortest code has 5 bits */
+			if(length < 5) {
+				continue;
+			}
+			auto iter = symbols.find((static_cast<std::uint64_t>(length) << 32) | code);
+			if(iter != symbols.end()) {
+				result += static_cast<char>(iter->second);
+				code = 0;
+				length = 0;
+			}
+			else if(length >= 30) {
+				return false;
+			}
+		}
+	}
+
+	/* padding is a prefix of EOS, so it has at most 7 bits that are all set */
+	return length < 8 && code == (1u << length) - 1;
+}
+
+/* integer with a prefix of 'prefixBits' bits (RFC 7541, section 5.1) */
+bool decodeInteger(const std::string& block, std::size_t& pos, unsigned prefixBits, std::size_t& value) {
+	if(pos >= block.size()) {
+		return false;
+	}
+	std::size_t maxPrefix = (1u << prefixBits) - 1;
+	value = static_cast<unsigned char>(block[pos++]) & maxPrefix;
+	if(value < maxPrefix) {
+		return true;
+	}
+
+	for(unsigned shift = 0; shift < 28; shift += 7) {
+		if(pos >= block.size()) {
+			return false;
+		}
+		unsigned char octet = static_cast<unsigned char>(block[pos++]);
+		value += static_cast<std::size_t>(octet & 0x7f) << shift;
+		if((octet & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* string literal (RFC 7541, section 5.2) */
+bool decodeString(const std::string& block, std::size_t& pos, std::string& value) {
+	if(pos >= block.size()) {
+		return false;
+	}
+	bool huffman = (block[pos] & 0x80) != 0;
+	std::size_t length = 0;
+	if(!decodeInteger(block, pos, 7, length) || length > block.size() - pos) {
+		return false;
+	}
+
+	value.clear();
+	if(huffman) {
+		if(!decodeHuffman(block.substr(pos, length), value)) {
+			return false;
+		}
+	}
+	else {
+		value.assign(block, pos, length);
+	}
+	pos += length;
+	return true;
+}
+
+void encodeInteger(std::string& block, unsigned char flags, unsigned prefixBits, std::size_t value) {
+	std::size_t maxPrefix = (1u << prefixBits) - 1;
+	if(value < maxPrefix) {
+		block += static_cast<char>(flags | value);
+		return;
+	}
+
+	block += static_cast<char>(flags | maxPrefix);
+	value -= maxPrefix;
+	while(value >= 0x80) {
+		block += static_cast<char>((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	block += static_cast<char>(value);
+}
+
+void encodeString(std::string& block, const std::string& value) {
+	encodeInteger(block, 0, 7, value.size());
+	block += value;
+}
+}  // anonymer namespace
+
+bool Hpack::decode(const std::string& block, Headers& headers) {
+	std::size_t pos = 0;
+	while(pos < block.size()) {
+		unsigned char type = static_cast<unsigned char>(block[pos]);
+		std::size_t index = 0;
+		Field field;
+
+		if(type & 0x80) {
+			/* indexed header field */
+			if(!decodeInteger(block, pos, 7, index) || !getField(index, field)) {
+				return false;
+			}
+			headers.push_back(std::move(field));
+			continue;
+		}
+
+		if((type & 0xe0) == 0x20) {
+			/* dynamic table size update */
+			if(!decodeInteger(block, pos, 5, index)) {
+				return false;
+			}
+			maxDynamicTableSize = index;
+			evict(maxDynamicTableSize);
+			continue;
+		}
+
+		/* literal with incremental indexing has a prefix of 6 bits, without indexing and never indexed one of 4 bits */
+		bool indexing = (type & 0xc0) == 0x40;
+		if(!decodeInteger(block, pos, indexing ? 6 : 4, index)) {
+			return false;
+		}
+		if(index > 0) {
+			if(!getField(index, field)) {
+				return false;
+			}
+		}
+		else if(!decodeString(block, pos, field.first)) {
+			return false;
+		}
+		if(!decodeString(block, pos, field.second)) {
+			return false;
+		}
+
+		if(indexing) {
+			addField(field);
+		}
+		headers.push_back(std::move(field));
+	}
+	return true;
+}
+
+std::string Hpack::encode(const Headers& headers) {
+	std::string block;
+	for(const auto& header : headers) {
+		std::string name = header.first;
+		for(auto& c : name) {
+			c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+
+		/* literal without indexing with a new name */
+		block += '\0';
+		encodeString(block, name);
+		encodeString(block, header.second);
+	}
+	return block;
+}
+
+bool Hpack::getField(std::size_t index, Field& field) const {
+	if(index == 0) {
+		return false;
+	}
+	if(index <= staticTableSize) {
+		field = Field(staticTable[index - 1].first, staticTable[index - 1].second);
+		return true;
+	}
+	index -= staticTableSize + 1;
+	if(index >= dynamicTable.size()) {
+		return false;
+	}
+	field = dynamicTable[index];
+	return true;
+}
+
+void Hpack::addField(Field field) {
+	/* the size of an entry includes an overhead of 32 octets */
+	std::size_t size = field.first.size() + field.second.size() + 32;
+	if(size > maxDynamicTableSize) {
+		evict(0);
+		return;
+	}
+	evict(maxDynamicTableSize - size);
+	dynamicTableSize += size;
+	dynamicTable.push_front(std::move(field));
+}
+
+void Hpack::evict(std::size_t maxSize) {
+	while(dynamicTableSize > maxSize) {
+		dynamicTableSize -= dynamicTable.back().first.size() + dynamicTable.back().second.size() + 32;
+		dynamicTable.pop_back();
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,70 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_HPACK_H_
+#define CURL4ESL_COM_HTTP_CLIENT_HPACK_H_
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Header compression of HTTP/2 (RFC 7541) for the h2c connections of LoopbackServer.
+ * An object holds the dynamic table of a single connection for decoding. */
+class Hpack {
+public:
+	using Headers = std::vector<std::pair<std::string, std::string>>;
+
+	/* appends the fields of a header block to 'headers', returns false if the block is malformed */
+	bool decode(const std::string& block, Headers& headers);
+
+	/* Encodes all fields as literals without indexing and without Huffman coding,
+	 * so the encoder needs no state. Names are converted to lower case. */
+	static std::string encode(const Headers& headers);
+
+private:
+	using Field = std::pair<std::string, std::string>;
+
+	bool getField(std::size_t index, Field& field) const;
+	void addField(Field field);
+	void evict(std::size_t maxSize);
+
+	/* newest field first */
+	std::deque<Field> dynamicTable;
+	std::size_t dynamicTableSize = 0;
+	std::size_t maxDynamicTableSize = 4096;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_HPACK_H_ */
@@ -0,0 +1,1008 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/Hpack.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <stdexcept>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+bool equalsIgnoreCase(const std::string& a, const std::string& b) {
+	if(a.size() != b.size()) {
+		return false;
+	}
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		if(std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string trim(const std::string& value) {
+	std::size_t begin = value.find_first_not_of(" \t");
+	if(begin == std::string::npos) {
+		return std::string();
+	}
+	return value.substr(begin, value.find_last_not_of(" \t") - begin + 1);
+}
+
+const char* getReason(int statusCode) {
+	switch(statusCode) {
+	case 100: return "Continue";
+	case 200: return "OK";
+	case 204: return "No Content";
+	case 206: return "Partial Content";
+	case 304: return "Not Modified";
+	case 404: return "Not Found";
+	case 416: return "Range Not Satisfiable";
+	case 429: return "Too Many Requests";
+	case 500: return "Internal Server Error";
+	case 503: return "Service Unavailable";
+	default: return "Unknown";
+	}
+}
+
+/* HTTP/2 is preferred if the client offers it */
+int selectProtocol(SSL*, const unsigned char** out, unsigned char* outSize, const unsigned char* in, unsigned int inSize, void*) {
+	static const unsigned char protocols[] = "\x02h2\x08http/1.1";
+	unsigned char* selected = nullptr;
+	if(SSL_select_next_proto(&selected, outSize, protocols, sizeof(protocols) - 1, in, inSize) != OPENSSL_NPN_NEGOTIATED) {
+		return SSL_TLSEXT_ERR_NOACK;
+	}
+	*out = selected;
+	return SSL_TLSEXT_ERR_OK;
+}
+
+/* self-signed certificate for "127.0.0.1" with a new P-256 key, valid for a day */
+SSL_CTX* createSslContext() {
+	EVP_PKEY* key = nullptr;
+	EVP_PKEY_CTX* keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+	bool keyCreated = keyContext
+			&& EVP_PKEY_keygen_init(keyContext) > 0
+			&& EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1) > 0
+			&& EVP_PKEY_keygen(keyContext, &key) > 0;
+	EVP_PKEY_CTX_free(keyContext);
+	if(!keyCreated) {
+		throw std::runtime_error("curl4esl: cannot create key of loopback server");
+	}
+
+	X509* certificate = X509_new();
+	X509_NAME* name = certificate ? X509_get_subject_name(certificate) : nullptr;
+	bool certificateCreated = name
+			&& ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1) == 1
+			&& X509_gmtime_adj(X509_getm_notBefore(certificate), 0)
+			&& X509_gmtime_adj(X509_getm_notAfter(certificate), 24 * 60 * 60)
+			&& X509_set_pubkey(certificate, key) == 1
+			&& X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1, 0) == 1
+			&& X509_set_issuer_name(certificate, name) == 1
+			&& X509_sign(certificate, key, EVP_sha256()) > 0;
+
+	SSL_CTX* context = certificateCreated ? SSL_CTX_new(TLS_server_method()) : nullptr;
+	if(context && (SSL_CTX_use_certificate(context, certificate) != 1 || SSL_CTX_use_PrivateKey(context, key) != 1)) {
+		SSL_CTX_free(context);
+		context = nullptr;
+	}
+	if(context) {
+		SSL_CTX_set_alpn_select_cb(context, selectProtocol, nullptr);
+	}
+	X509_free(certificate);
+	EVP_PKEY_free(key);
+
+	if(context == nullptr) {
+		throw std::runtime_error("curl4esl: cannot create TLS context of loopback server");
+	}
+	return context;
+}
+
+/* connection to a client, with TLS if 'ssl' is set */
+class Channel {
+public:
+	Channel(int aSocket, SSL* aSsl)
+	: socket(aSocket),
+	  ssl(aSsl)
+	{ }
+
+	/* returns 0 or less if the connection has been closed */
+	ssize_t recv(char* data, std::size_t size) {
+		if(ssl) {
+			return SSL_read(ssl, data, static_cast<int>(std::min<std::size_t>(size, INT_MAX)));
+		}
+		return ::recv(socket, data, size, 0);
+	}
+
+	ssize_t send(const char* data, std::size_t size) {
+		if(ssl) {
+			return SSL_write(ssl, data, static_cast<int>(std::min<std::size_t>(size, INT_MAX)));
+		}
+		return ::send(socket, data, size, MSG_NOSIGNAL);
+	}
+
+	/* Waits up to 'timeout' milliseconds, -1 without limit, for data to read.
+	 * Returns a positive value if there is data, 0 on timeout and a negative value on failure. */
+	int wait(int timeout) {
+		if(ssl && SSL_pending(ssl) > 0) {
+			return 1;
+		}
+
+		pollfd descriptor;
+		descriptor.fd = socket;
+		descriptor.events = POLLIN;
+		descriptor.revents = 0;
+		int rc = ::poll(&descriptor, 1, timeout);
+		return rc < 0 && errno == EINTR ? 0 : rc;
+	}
+
+private:
+	int socket;
+	SSL* ssl;
+};
+
+/* buffered reading from a channel */
+class Stream {
+public:
+	Stream(Channel& aChannel)
+	: channel(aChannel)
+	{ }
+
+	/* returns false if the connection has been closed before a complete line has been received */
+	bool readLine(std::string& line) {
+		while(true) {
+			std::size_t pos = buffer.find("\r\n", offset);
+			if(pos != std::string::npos) {
+				line = buffer.substr(offset, pos - offset);
+				offset = pos + 2;
+				return true;
+			}
+			if(!fill()) {
+				return false;
+			}
+		}
+	}
+
+	bool read(std::string& data, std::size_t size) {
+		while(buffer.size() - offset < size) {
+			if(!fill()) {
+				return false;
+			}
+		}
+		data.append(buffer, offset, size);
+		offset += size;
+		return true;
+	}
+
+	/* size of the data that has been received already, but not been read */
+	std::size_t available() const noexcept {
+		return buffer.size() - offset;
+	}
+
+private:
+	bool fill() {
+		if(offset > 0) {
+			buffer.erase(0, offset);
+			offset = 0;
+		}
+
+		char chunk[64 * 1024];
+		ssize_t size = channel.recv(chunk, sizeof(chunk));
+		if(size <= 0) {
+			return false;
+		}
+		buffer.append(chunk, static_cast<std::size_t>(size));
+		return true;
+	}
+
+	Channel& channel;
+	std::string buffer;
+	std::size_t offset = 0;
+};
+
+bool sendAll(Channel& channel, const char* data, std::size_t size) {
+	while(size > 0) {
+		ssize_t sent = channel.send(data, size);
+		if(sent <= 0) {
+			return false;
+		}
+		data += sent;
+		size -= static_cast<std::size_t>(sent);
+	}
+	return true;
+}
+
+void sendResponse(Channel& channel, const LoopbackServer::Request& request, const LoopbackServer::Response& response) {
+	const std::string& body = response.sharedBody ? *response.sharedBody : response.body;
+
+	std::string head = "HTTP/1.1 " + std::to_string(response.statusCode) + " " + getReason(response.statusCode) + "\r\n";
+	bool hasContentLength = false;
+	for(const auto& header : response.headers) {
+		if(equalsIgnoreCase(header.first, "Content-Length")) {
+			hasContentLength = true;
+		}
+		head += header.first + ": " + header.second + "\r\n";
+	}
+	if(!hasContentLength && response.statusCode != 204 && response.statusCode != 304) {
+		head += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+	}
+	head += "\r\n";
+
+	if(!sendAll(channel, head.data(), head.size())) {
+		return;
+	}
+	if(request.method != "HEAD") {
+		sendAll(channel, body.data(), std::min(body.size(), response.truncateBody));
+	}
+}
+
+/* frame types, flags and settings of HTTP/2 (RFC 7540, section 6) */
+constexpr std::uint8_t frameData = 0x0;
+constexpr std::uint8_t frameHeaders = 0x1;
+constexpr std::uint8_t frameRstStream = 0x3;
+constexpr std::uint8_t frameSettings = 0x4;
+constexpr std::uint8_t framePing = 0x6;
+constexpr std::uint8_t frameGoaway = 0x7;
+constexpr std::uint8_t frameWindowUpdate = 0x8;
+constexpr std::uint8_t frameContinuation = 0x9;
+
+constexpr std::uint8_t flagEndStream = 0x1;
+constexpr std::uint8_t flagAck = 0x1;
+constexpr std::uint8_t flagEndHeaders = 0x4;
+constexpr std::uint8_t flagPadded = 0x8;
+constexpr std::uint8_t flagPriority = 0x20;
+
+constexpr std::uint16_t settingsInitialWindowSize = 0x4;
+
+constexpr std::size_t frameHeaderSize = 9;
+/* SETTINGS_MAX_FRAME_SIZE of the client is never smaller */
+constexpr std::size_t maxFrameSize = 16384;
+constexpr std::int64_t defaultWindowSize = 65535;
+
+std::uint32_t readUint32(const std::string& data, std::size_t pos) {
+	return (static_cast<std::uint32_t>(static_cast<unsigned char>(data[pos])) << 24)
+			| (static_cast<std::uint32_t>(static_cast<unsigned char>(data[pos + 1])) << 16)
+			| (static_cast<std::uint32_t>(static_cast<unsigned char>(data[pos + 2])) << 8)
+			| static_cast<std::uint32_t>(static_cast<unsigned char>(data[pos + 3]));
+}
+
+void appendUint32(std::string& data, std::uint32_t value) {
+	data += static_cast<char>((value >> 24) & 0xff);
+	data += static_cast<char>((value >> 16) & 0xff);
+	data += static_cast<char>((value >> 8) & 0xff);
+	data += static_cast<char>(value & 0xff);
+}
+
+/* Serves a connection that has sent the HTTP/2 connection preface, after ALPN or with prior knowledge (h2c).
+ * A stream is answered when its request is complete. The delay of a response does not hold back
+ * other streams, and bodies are sent within the flow control windows of the client. */
+class Http2Connection {
+public:
+	using Answer = std::function<LoopbackServer::Response (const LoopbackServer::Request&)>;
+
+	Http2Connection(Channel& aChannel, Stream& aStream, std::size_t aConnection, Answer aAnswer)
+	: channel(aChannel),
+	  stream(aStream),
+	  connection(aConnection),
+	  answer(std::move(aAnswer))
+	{ }
+
+	void serve() {
+		/* the server preface is a SETTINGS frame, the defaults are fine */
+		if(!sendFrame(frameSettings, 0, 0, nullptr, 0)) {
+			return;
+		}
+
+		while(sendResponses()) {
+			if(stream.available() < frameHeaderSize) {
+				int rc = channel.wait(getTimeout());
+				if(rc == 0) {
+					continue;
+				}
+				if(rc < 0) {
+					return;
+				}
+			}
+
+			std::string header;
+			if(!stream.read(header, frameHeaderSize)) {
+				return;
+			}
+			std::size_t length = (readUint32(header, 0) >> 8) & 0xffffff;
+			std::uint8_t type = static_cast<std::uint8_t>(header[3]);
+			std::uint8_t flags = static_cast<std::uint8_t>(header[4]);
+			std::uint32_t streamId = readUint32(header, 5) & 0x7fffffff;
+
+			std::string payload;
+			if(!stream.read(payload, length) || !receiveFrame(type, flags, streamId, payload)) {
+				return;
+			}
+		}
+	}
+
+private:
+	struct ReceivingStream {
+		LoopbackServer::Request request;
+		std::string headerBlock;
+		bool endStream = false;
+	};
+
+	struct SendingStream {
+		std::uint32_t id = 0;
+		LoopbackServer::Response response;
+		bool headOnly = false;
+		std::chrono::steady_clock::time_point readyAt;
+		bool headersSent = false;
+		std::size_t offset = 0;
+		std::int64_t window = defaultWindowSize;
+
+		const std::string& getBody() const {
+			return response.sharedBody ? *response.sharedBody : response.body;
+		}
+	};
+
+	/* returns false if the connection has to be closed */
+	bool receiveFrame(std::uint8_t type, std::uint8_t flags, std::uint32_t streamId, std::string& payload) {
+		/* a header block must not be interrupted by other frames */
+		if(continuationStream != 0 && (type != frameContinuation || streamId != continuationStream)) {
+			return false;
+		}
+
+		switch(type) {
+		case frameData: {
+			std::size_t received = payload.size();
+			if(!removePadding(flags, payload)) {
+				return false;
+			}
+			auto iter = receivingStreams.find(streamId);
+			if(iter != receivingStreams.end()) {
+				iter->second.request.body += payload;
+			}
+
+			/* the window is given back at once, so uploads are not limited by flow control */
+			if(received > 0) {
+				if(!sendWindowUpdate(0, received)) {
+					return false;
+				}
+				if(iter != receivingStreams.end() && (flags & flagEndStream) == 0 && !sendWindowUpdate(streamId, received)) {
+					return false;
+				}
+			}
+
+			if(iter != receivingStreams.end() && (flags & flagEndStream)) {
+				answerStream(iter);
+			}
+			return true;
+		}
+		case frameHeaders: {
+			if(!removePadding(flags, payload)) {
+				return false;
+			}
+			if(flags & flagPriority) {
+				if(payload.size() < 5) {
+					return false;
+				}
+				payload.erase(0, 5);
+			}
+
+			ReceivingStream& receivingStream = getReceivingStream(streamId);
+			receivingStream.headerBlock = std::move(payload);
+			receivingStream.endStream = (flags & flagEndStream) != 0;
+			if(flags & flagEndHeaders) {
+				return completeHeaders(streamId);
+			}
+			continuationStream = streamId;
+			return true;
+		}
+		case frameContinuation:
+			if(continuationStream != streamId) {
+				return false;
+			}
+			getReceivingStream(streamId).headerBlock += payload;
+			if(flags & flagEndHeaders) {
+				continuationStream = 0;
+				return completeHeaders(streamId);
+			}
+			return true;
+		case frameRstStream:
+			receivingStreams.erase(streamId);
+			for(auto iter = sendingStreams.begin(); iter != sendingStreams.end(); ++iter) {
+				if(iter->id == streamId) {
+					sendingStreams.erase(iter);
+					break;
+				}
+			}
+			return true;
+		case frameSettings:
+			if(flags & flagAck) {
+				return true;
+			}
+			for(std::size_t pos = 0; pos + 6 <= payload.size(); pos += 6) {
+				std::uint16_t id = static_cast<std::uint16_t>((static_cast<unsigned char>(payload[pos]) << 8) | static_cast<unsigned char>(payload[pos + 1]));
+				if(id == settingsInitialWindowSize) {
+					std::int64_t value = readUint32(payload, pos + 2);
+					for(auto& sendingStream : sendingStreams) {
+						sendingStream.window += value - initialWindowSize;
+					}
+					initialWindowSize = value;
+				}
+			}
+			return sendFrame(frameSettings, flagAck, 0, nullptr, 0);
+		case framePing:
+			if(flags & flagAck) {
+				return true;
+			}
+			return sendFrame(framePing, flagAck, 0, payload.data(), payload.size());
+		case frameGoaway:
+			return false;
+		case frameWindowUpdate:
+			if(payload.size() != 4) {
+				return false;
+			}
+			if(streamId == 0) {
+				connectionWindow += readUint32(payload, 0) & 0x7fffffff;
+			}
+			for(auto& sendingStream : sendingStreams) {
+				if(sendingStream.id == streamId) {
+					sendingStream.window += readUint32(payload, 0) & 0x7fffffff;
+				}
+			}
+			return true;
+		default:
+			/* PRIORITY and unknown frames */
+			return true;
+		}
+	}
+
+	static bool removePadding(std::uint8_t flags, std::string& payload) {
+		if((flags & flagPadded) == 0) {
+			return true;
+		}
+		if(payload.empty()) {
+			return false;
+		}
+		std::size_t padding = static_cast<unsigned char>(payload[0]);
+		if(padding + 1 > payload.size()) {
+			return false;
+		}
+		payload = payload.substr(1, payload.size() - 1 - padding);
+		return true;
+	}
+
+	ReceivingStream& getReceivingStream(std::uint32_t streamId) {
+		ReceivingStream& receivingStream = receivingStreams[streamId];
+		receivingStream.request.connection = connection;
+		return receivingStream;
+	}
+
+	bool completeHeaders(std::uint32_t streamId) {
+		auto iter = receivingStreams.find(streamId);
+
+		/* every header block is decoded, so the dynamic table stays in sync with the one of the client */
+		Hpack::Headers fields;
+		if(!hpack.decode(iter->second.headerBlock, fields)) {
+			return false;
+		}
+		iter->second.headerBlock.clear();
+
+		/* a second header block of a request contains trailers */
+		LoopbackServer::Request& request = iter->second.request;
+		if(request.method.empty()) {
+			for(auto& field : fields) {
+				if(field.first == ":method") {
+					request.method = field.second;
+				}
+				else if(field.first == ":path") {
+					request.path = field.second;
+				}
+				else if(field.first.empty() || field.first[0] != ':') {
+					request.headers.push_back(std::move(field));
+				}
+			}
+		}
+
+		if(iter->second.endStream) {
+			answerStream(iter);
+		}
+		return true;
+	}
+
+	void answerStream(std::map<std::uint32_t, ReceivingStream>::iterator iter) {
+		SendingStream sendingStream;
+		sendingStream.id = iter->first;
+		sendingStream.response = answer(iter->second.request);
+		sendingStream.headOnly = iter->second.request.method == "HEAD";
+		sendingStream.readyAt = std::chrono::steady_clock::now() + sendingStream.response.delay;
+		sendingStream.window = initialWindowSize;
+
+		receivingStreams.erase(iter);
+		sendingStreams.push_back(std::move(sendingStream));
+	}
+
+	/* sends as much of the responses as the windows allow, returns false if the connection has to be closed */
+	bool sendResponses() {
+		auto now = std::chrono::steady_clock::now();
+		delayed = false;
+		for(auto iter = sendingStreams.begin(); iter != sendingStreams.end();) {
+			SendingStream& sendingStream = *iter;
+			if(sendingStream.readyAt > now) {
+				if(!delayed || sendingStream.readyAt < nextReadyAt) {
+					nextReadyAt = sendingStream.readyAt;
+					delayed = true;
+				}
+				++iter;
+				continue;
+			}
+			if(sendingStream.response.drop) {
+				return false;
+			}
+
+			const std::string& body = sendingStream.getBody();
+			std::size_t end = sendingStream.headOnly ? 0 : std::min(body.size(), sendingStream.response.truncateBody);
+			if(!sendingStream.headersSent) {
+				if(!sendHeaders(sendingStream, sendingStream.headOnly || body.empty())) {
+					return false;
+				}
+				sendingStream.headersSent = true;
+			}
+
+			while(sendingStream.offset < end) {
+				std::int64_t window = std::min(sendingStream.window, connectionWindow);
+				if(window <= 0) {
+					break;
+				}
+				std::size_t size = std::min(std::min(end - sendingStream.offset, maxFrameSize), static_cast<std::size_t>(window));
+				bool last = sendingStream.offset + size == body.size();
+				if(!sendFrame(frameData, last ? flagEndStream : 0, sendingStream.id, &body[sendingStream.offset], size)) {
+					return false;
+				}
+				sendingStream.offset += size;
+				sendingStream.window -= static_cast<std::int64_t>(size);
+				connectionWindow -= static_cast<std::int64_t>(size);
+			}
+
+			if(sendingStream.offset < end) {
+				++iter;
+				continue;
+			}
+			/* like a connection dropped during a transfer */
+			if(!sendingStream.headOnly && end < body.size()) {
+				return false;
+			}
+			iter = sendingStreams.erase(iter);
+		}
+		return true;
+	}
+
+	bool sendHeaders(const SendingStream& sendingStream, bool endStream) {
+		const LoopbackServer::Response& response = sendingStream.response;
+
+		Hpack::Headers fields;
+		fields.emplace_back(":status", std::to_string(response.statusCode));
+		bool hasContentLength = false;
+		for(const auto& header : response.headers) {
+			/* connection specific headers are not allowed in HTTP/2 */
+			if(equalsIgnoreCase(header.first, "Connection") || equalsIgnoreCase(header.first, "Keep-Alive")
+			|| equalsIgnoreCase(header.first, "Transfer-Encoding") || equalsIgnoreCase(header.first, "Upgrade")) {
+				continue;
+			}
+			if(equalsIgnoreCase(header.first, "Content-Length")) {
+				hasContentLength = true;
+			}
+			fields.push_back(header);
+		}
+		if(!hasContentLength && response.statusCode != 204 && response.statusCode != 304) {
+			fields.emplace_back("content-length", std::to_string(sendingStream.getBody().size()));
+		}
+
+		std::string block = Hpack::encode(fields);
+		std::size_t size = std::min(block.size(), maxFrameSize);
+		std::uint8_t flags = static_cast<std::uint8_t>((endStream ? flagEndStream : 0) | (size == block.size() ? flagEndHeaders : 0));
+		if(!sendFrame(frameHeaders, flags, sendingStream.id, block.data(), size)) {
+			return false;
+		}
+		for(std::size_t pos = size; pos < block.size(); pos += size) {
+			size = std::min(block.size() - pos, maxFrameSize);
+			if(!sendFrame(frameContinuation, pos + size == block.size() ? flagEndHeaders : 0, sendingStream.id, &block[pos], size)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool sendWindowUpdate(std::uint32_t streamId, std::size_t increment) {
+		std::string payload;
+		appendUint32(payload, static_cast<std::uint32_t>(increment));
+		return sendFrame(frameWindowUpdate, 0, streamId, payload.data(), payload.size());
+	}
+
+	bool sendFrame(std::uint8_t type, std::uint8_t flags, std::uint32_t streamId, const char* data, std::size_t size) {
+		std::string frame;
+		frame.reserve(frameHeaderSize + size);
+		appendUint32(frame, static_cast<std::uint32_t>(size << 8) | type);
+		frame += static_cast<char>(flags);
+		appendUint32(frame, streamId);
+		frame.append(data, size);
+		return sendAll(channel, frame.data(), frame.size());
+	}
+
+	/* Milliseconds until the next response skipped by sendResponses is ready, -1 if there is none.
+	 * It may have become ready in the meantime, so it must not be looked up again with a later time. */
+	int getTimeout() const {
+		if(!delayed) {
+			return -1;
+		}
+		auto now = std::chrono::steady_clock::now();
+		if(nextReadyAt <= now) {
+			return 0;
+		}
+		/* rounded up, so it does not wake up too early */
+		return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextReadyAt - now).count()) + 1;
+	}
+
+	Channel& channel;
+	Stream& stream;
+	std::size_t connection;
+	Answer answer;
+
+	Hpack hpack;
+	std::map<std::uint32_t, ReceivingStream> receivingStreams;
+	std::list<SendingStream> sendingStreams;
+	/* stream of a header block that continues in CONTINUATION frames, 0 if there is none */
+	std::uint32_t continuationStream = 0;
+	/* set by sendResponses if a response has been skipped because of its delay */
+	bool delayed = false;
+	std::chrono::steady_clock::time_point nextReadyAt;
+	std::int64_t connectionWindow = defaultWindowSize;
+	std::int64_t initialWindowSize = defaultWindowSize;
+};
+}  // anonymer namespace
+
+const std::string* LoopbackServer::Request::findHeader(const std::string& key) const {
+	for(const auto& header : headers) {
+		if(equalsIgnoreCase(header.first, key)) {
+			return &header.second;
+		}
+	}
+	return nullptr;
+}
+
+LoopbackServer::LoopbackServer(Handler aHandler, Scheme aScheme)
+: handler(std::move(aHandler)),
+  scheme(aScheme),
+  listenSocket(::socket(AF_INET, SOCK_STREAM, 0))
+{
+	if(listenSocket < 0) {
+		throw std::runtime_error("curl4esl: cannot create socket of loopback server");
+	}
+
+	int reuse = 1;
+	::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+
+	socklen_t addressSize = sizeof(address);
+	if(::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+	|| ::listen(listenSocket, 128) != 0
+	|| ::getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0) {
+		::close(listenSocket);
+		throw std::runtime_error("curl4esl: cannot listen on loopback interface");
+	}
+	port = ntohs(address.sin_port);
+
+	if(scheme == Scheme::https) {
+		try {
+			sslContext = createSslContext();
+		}
+		catch(...) {
+			::close(listenSocket);
+			throw;
+		}
+	}
+
+	acceptThread = std::thread(&LoopbackServer::accept, this);
+}
+
+LoopbackServer::~LoopbackServer() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopped = true;
+		for(auto& openSocket : openSockets) {
+			::shutdown(openSocket.second, SHUT_RDWR);
+		}
+	}
+
+	/* wakes up the accepting thread */
+	::shutdown(listenSocket, SHUT_RDWR);
+	acceptThread.join();
+	::close(listenSocket);
+
+	for(auto& thread : threads) {
+		thread.second.join();
+	}
+
+	SSL_CTX_free(sslContext);
+}
+
+std::string LoopbackServer::getUrl() const {
+	return std::string(scheme == Scheme::https ? "https" : "http") + "://127.0.0.1:" + std::to_string(port);
+}
+
+unsigned short LoopbackServer::getPort() const noexcept {
+	return port;
+}
+
+void LoopbackServer::setRecording(bool aRecording) {
+	std::lock_guard<std::mutex> lock(mutex);
+	recording = aRecording;
+}
+
+void LoopbackServer::setExpectContinue(bool aExpectContinue) {
+	std::lock_guard<std::mutex> lock(mutex);
+	expectContinue = aExpectContinue;
+}
+
+std::vector<LoopbackServer::Request> LoopbackServer::getRequests() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return requests;
+}
+
+std::size_t LoopbackServer::getConnections() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return connections;
+}
+
+std::size_t LoopbackServer::getHandshakes() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return handshakes;
+}
+
+std::size_t LoopbackServer::getResumedHandshakes() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return resumedHandshakes;
+}
+
+void LoopbackServer::accept() {
+	while(true) {
+		int socket = ::accept(listenSocket, nullptr, nullptr);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if(socket < 0 || stopped) {
+			if(socket >= 0) {
+				::close(socket);
+			}
+			if(stopped) {
+				break;
+			}
+			continue;
+		}
+
+		int noDelay = 1;
+		::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+		/* threads of closed connections are joined here, so churning connections do not accumulate them */
+		for(auto finished : finishedThreads) {
+			auto iter = threads.find(finished);
+			iter->second.join();
+			threads.erase(iter);
+		}
+		finishedThreads.clear();
+
+		std::size_t connection = ++connections;
+		openSockets[connection] = socket;
+		threads[connection] = std::thread(&LoopbackServer::serve, this, socket, connection);
+	}
+}
+
+void LoopbackServer::serve(int socket, std::size_t connection) {
+	/* OpenSSL writes to the socket without MSG_NOSIGNAL, so a closed connection must not terminate the process */
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	SSL* ssl = nullptr;
+	if(sslContext) {
+		ssl = SSL_new(sslContext);
+		if(ssl && (SSL_set_fd(ssl, socket) != 1 || SSL_accept(ssl) != 1)) {
+			SSL_free(ssl);
+			ssl = nullptr;
+		}
+		if(ssl) {
+			std::lock_guard<std::mutex> lock(mutex);
+			++handshakes;
+			if(SSL_session_reused(ssl)) {
+				++resumedHandshakes;
+			}
+		}
+	}
+	bool established = sslContext == nullptr || ssl != nullptr;
+	Channel channel(socket, ssl);
+	Stream stream(channel);
+
+	while(established) {
+		Request request;
+		request.connection = connection;
+
+		std::string line;
+		if(!stream.readLine(line)) {
+			break;
+		}
+		std::size_t methodEnd = line.find(' ');
+		std::size_t pathEnd = line.find(' ', methodEnd + 1);
+		if(methodEnd == std::string::npos || pathEnd == std::string::npos) {
+			break;
+		}
+		request.method = line.substr(0, methodEnd);
+		request.path = line.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+
+		/* the rest of the HTTP/2 connection preface "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n" */
+		if(line == "PRI * HTTP/2.0") {
+			std::string empty;
+			std::string sm;
+			if(stream.readLine(empty) && empty.empty() && stream.readLine(sm) && sm == "SM" && stream.readLine(empty) && empty.empty()) {
+				Http2Connection(channel, stream, connection, [this](const Request& http2Request) {
+					Response response = handler ? handler(http2Request) : Response();
+					std::lock_guard<std::mutex> lock(mutex);
+					if(recording) {
+						requests.push_back(http2Request);
+					}
+					return response;
+				}).serve();
+			}
+			break;
+		}
+
+		bool complete = false;
+		while(stream.readLine(line)) {
+			if(line.empty()) {
+				complete = true;
+				break;
+			}
+			std::size_t separator = line.find(':');
+			if(separator != std::string::npos) {
+				request.headers.emplace_back(trim(line.substr(0, separator)), trim(line.substr(separator + 1)));
+			}
+		}
+		if(!complete) {
+			break;
+		}
+
+		bool answerContinue;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			answerContinue = expectContinue;
+		}
+
+		const std::string* expect = request.findHeader("Expect");
+		if(answerContinue && expect && equalsIgnoreCase(*expect, "100-continue")) {
+			static const std::string continueLine = "HTTP/1.1 100 Continue\r\n\r\n";
+			if(!sendAll(channel, continueLine.data(), continueLine.size())) {
+				break;
+			}
+		}
+
+		const std::string* transferEncoding = request.findHeader("Transfer-Encoding");
+		const std::string* contentLength = request.findHeader("Content-Length");
+		if(transferEncoding && equalsIgnoreCase(*transferEncoding, "chunked")) {
+			request.chunked = true;
+			while(true) {
+				if(!stream.readLine(line)) {
+					complete = false;
+					break;
+				}
+				std::size_t chunkSize = std::strtoul(line.c_str(), nullptr, 16);
+				if(chunkSize == 0) {
+					/* trailer ends with an empty line */
+					while(stream.readLine(line) && !line.empty()) {
+					}
+					break;
+				}
+				if(!stream.read(request.body, chunkSize) || !stream.readLine(line)) {
+					complete = false;
+					break;
+				}
+			}
+		}
+		else if(contentLength) {
+			complete = stream.read(request.body, std::strtoul(contentLength->c_str(), nullptr, 10));
+		}
+		if(!complete) {
+			break;
+		}
+
+		Response response = handler ? handler(request) : Response();
+		if(response.delay.count() > 0) {
+			std::this_thread::sleep_for(response.delay);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(recording) {
+				requests.push_back(request);
+			}
+		}
+
+		if(response.drop) {
+			break;
+		}
+
+		const std::string* connectionHeader = request.findHeader("Connection");
+		bool close = connectionHeader && equalsIgnoreCase(*connectionHeader, "close");
+		if(close) {
+			response.headers.emplace_back("Connection", "close");
+		}
+
+		sendResponse(channel, request, response);
+
+		const std::string& body = response.sharedBody ? *response.sharedBody : response.body;
+		if(close || response.truncateBody < body.size()) {
+			break;
+		}
+	}
+
+	if(ssl) {
+		SSL_shutdown(ssl);
+		SSL_free(ssl);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	::close(socket);
+	openSockets.erase(connection);
+	if(!stopped) {
+		finishedThreads.push_back(connection);
+	}
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
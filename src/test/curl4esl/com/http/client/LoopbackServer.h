@@ -0,0 +1,141 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_LOOPBACKSERVER_H_
+#define CURL4ESL_COM_HTTP_CLIENT_LOOPBACKSERVER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/* SSL_CTX of OpenSSL */
+struct ssl_ctx_st;
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* HTTP server on 127.0.0.1 for tests and benchmarks. Each connection is served by a
+ * thread of its own, requests are answered by the handler and recorded in their order.
+ * With scheme https it uses TLS with a self-signed certificate, so clients must skip the verification.
+ * HTTP/2 is served if it is negotiated by ALPN with scheme https or sent with prior knowledge (h2c) with scheme http. */
+class LoopbackServer {
+public:
+	enum class Scheme {
+		http,
+		https
+	};
+
+	struct Request {
+		/* number of the connection the request has been received on, starting with 1 */
+		std::size_t connection = 0;
+		std::string method;
+		std::string path;
+		std::vector<std::pair<std::string, std::string>> headers;
+		bool chunked = false;
+		std::string body;
+
+		/* returns the value of the first header with this name, the name is case insensitive */
+		const std::string* findHeader(const std::string& key) const;
+	};
+
+	struct Response {
+		int statusCode = 200;
+		/* Content-Length is added if it is not set */
+		std::vector<std::pair<std::string, std::string>> headers;
+		std::string body;
+		/* sent instead of 'body' if it is set, so a large body is not copied for each response */
+		std::shared_ptr<const std::string> sharedBody;
+		/* waits before the response is sent */
+		std::chrono::milliseconds delay { 0 };
+		/* closes the connection instead of sending the response, like a server that dropped an idle connection */
+		bool drop = false;
+		/* closes the connection after this many bytes of the body, like a connection dropped during a transfer */
+		std::size_t truncateBody = std::string::npos;
+	};
+
+	using Handler = std::function<Response (const Request&)>;
+
+	/* answers every request with an empty 200 response if there is no handler */
+	LoopbackServer(Handler handler = nullptr, Scheme scheme = Scheme::http);
+	LoopbackServer(const LoopbackServer&) = delete;
+	~LoopbackServer();
+
+	LoopbackServer& operator=(const LoopbackServer&) = delete;
+
+	/* e.g. "http://127.0.0.1:40000" or "https://127.0.0.1:40000" */
+	std::string getUrl() const;
+	unsigned short getPort() const noexcept;
+
+	/* Requests are recorded with their body, benchmarks disable it to keep memory constant */
+	void setRecording(bool recording);
+
+	/* "Expect: 100-continue" is answered by default, otherwise the client waits for its timeout before it sends the body */
+	void setExpectContinue(bool expectContinue);
+	std::vector<Request> getRequests() const;
+	std::size_t getConnections() const;
+
+	/* TLS handshakes completed by scheme https, the resumed ones are counted by getResumedHandshakes() as well */
+	std::size_t getHandshakes() const;
+	std::size_t getResumedHandshakes() const;
+
+private:
+	void accept();
+	void serve(int socket, std::size_t connection);
+
+	Handler handler;
+	Scheme scheme;
+	ssl_ctx_st* sslContext = nullptr;
+	int listenSocket = -1;
+	unsigned short port = 0;
+
+	mutable std::mutex mutex;
+	bool stopped = false;
+	bool recording = true;
+	bool expectContinue = true;
+	std::vector<Request> requests;
+	std::size_t connections = 0;
+	std::size_t handshakes = 0;
+	std::size_t resumedHandshakes = 0;
+	std::map<std::size_t, int> openSockets;
+	std::map<std::size_t, std::thread> threads;
+	std::vector<std::size_t> finishedThreads;
+
+	std::thread acceptThread;
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_LOOPBACKSERVER_H_ */
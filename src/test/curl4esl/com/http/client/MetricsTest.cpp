@@ -0,0 +1,125 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/Metrics.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Output.h>
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+CURL4ESL_TEST(failedTransferIsNotRecordedInLatencies) {
+	std::string url;
+	{
+		/* nothing listens on the port after the server has been destroyed */
+		LoopbackServer server;
+		url = server.getUrl();
+	}
+	ConnectionFactory factory(TestUtility::createSettings(url));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	bool failed = false;
+	try {
+		std::string body;
+		connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+	}
+	catch(...) {
+		failed = true;
+	}
+	CURL4ESL_CHECK(failed);
+
+	Metrics::Snapshot snapshot = factory.getMetrics();
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.requestsByStatusClass[0]);
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.curlErrors[CURLE_COULDNT_CONNECT]);
+	for(std::size_t phase = 0; phase < Metrics::phaseCount; ++phase) {
+		CURL4ESL_CHECK_EQUAL(0u, snapshot.latency[phase].count);
+	}
+}
+
+CURL4ESL_TEST(successfulTransferIsRecordedInLatencies) {
+	LoopbackServer server;
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+
+	Metrics::Snapshot snapshot = factory.getMetrics();
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.requestsByStatusClass[2]);
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.latency[Metrics::preTransfer].count);
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.latency[Metrics::total].count);
+}
+
+CURL4ESL_TEST(cancelledHedgeIsNotCounted) {
+	std::atomic<int> received(0);
+	LoopbackServer server([&received](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		/* the first send is slow, so the hedge wins */
+		if(received++ == 0) {
+			response.delay = std::chrono::milliseconds(300);
+		}
+		return response;
+	});
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.hedgeDelay = 20;
+	settings.hedgeMaxRate = 100;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	std::string body;
+	std::future<esl::com::http::client::Response> future = connection.sendAsync(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+	CURL4ESL_CHECK_EQUAL(200, future.get().getStatusCode());
+
+	Metrics::Snapshot snapshot = factory.getMetrics();
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.hedgesIssued);
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.hedgesWon);
+	CURL4ESL_CHECK_EQUAL(0u, snapshot.requestsByStatusClass[0]);
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.requestsByStatusClass[2]);
+	CURL4ESL_CHECK(snapshot.curlErrors.empty());
+	CURL4ESL_CHECK_EQUAL(1u, snapshot.latency[Metrics::total].count);
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,210 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Connection.h>
+#include <esl/com/http/client/Request.h>
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+#include <esl/io/Output.h>
+#include <esl/io/Writer.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+esl::com::http::client::CURLConnectionFactory::Settings createCacheSettings(const std::string& url, std::size_t cacheSize) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(url);
+	settings.cacheSize = cacheSize;
+	return settings;
+}
+
+/* answers every request with 'body' and the given Cache-Control header */
+LoopbackServer::Handler createCacheable(const std::string& cacheControl, const std::string& body) {
+	return [cacheControl, body](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		response.headers.emplace_back("Cache-Control", cacheControl);
+		response.body = body;
+		return response;
+	};
+}
+
+std::string get(esl::com::http::client::Connection& connection, esl::com::http::client::Request request, int expectedStatusCode = 200) {
+	std::string body;
+	esl::com::http::client::Response response = connection.send(request, esl::io::Output(), TestUtility::createStringInput(body));
+	CURL4ESL_CHECK_EQUAL(expectedStatusCode, response.getStatusCode());
+	return body;
+}
+
+std::string get(esl::com::http::client::Connection& connection, const std::string& path) {
+	return get(connection, TestUtility::createRequest("GET", path));
+}
+
+CURL4ESL_TEST(freshResponseIsServedFromCache) {
+	LoopbackServer server(createCacheable("max-age=60", "cached"));
+	ConnectionFactory factory(createCacheSettings(server.getUrl(), 1024 * 1024));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	CURL4ESL_CHECK_EQUAL(std::string("cached"), get(*connection, "/"));
+	CURL4ESL_CHECK_EQUAL(std::string("cached"), get(*connection, "/"));
+
+	/* a connection of its own shares the cache of the factory */
+	std::unique_ptr<esl::com::http::client::Connection> otherConnection = factory.createConnection();
+	CURL4ESL_CHECK_EQUAL(std::string("cached"), get(*otherConnection, "/"));
+
+	CURL4ESL_CHECK_EQUAL(1u, server.getRequests().size());
+}
+
+CURL4ESL_TEST(staleResponseIsRevalidated) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.headers.emplace_back("ETag", "\"v1\"");
+		response.headers.emplace_back("Cache-Control", "max-age=0");
+
+		const std::string* ifNoneMatch = request.findHeader("If-None-Match");
+		if(ifNoneMatch && *ifNoneMatch == "\"v1\"") {
+			response.statusCode = 304;
+		}
+		else {
+			response.body = "payload";
+		}
+		return response;
+	});
+	ConnectionFactory factory(createCacheSettings(server.getUrl(), 1024 * 1024));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	CURL4ESL_CHECK_EQUAL(std::string("payload"), get(*connection, "/"));
+
+	/* the '304 Not Modified' is replayed through createInput like a '200 OK' */
+	CURL4ESL_CHECK_EQUAL(std::string("payload"), get(*connection, "/"));
+
+	/* ... and through the input of the send */
+	std::string body;
+	esl::io::Input input(std::unique_ptr<esl::io::Writer>(new TestUtility::StringWriter(body)));
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), std::move(input));
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(std::string("payload"), body);
+
+	std::vector<LoopbackServer::Request> requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(3u, requests.size());
+	CURL4ESL_CHECK(requests[0].findHeader("If-None-Match") == nullptr);
+	for(std::size_t i = 1; i < requests.size(); ++i) {
+		const std::string* ifNoneMatch = requests[i].findHeader("If-None-Match");
+		CURL4ESL_CHECK(ifNoneMatch != nullptr && *ifNoneMatch == "\"v1\"");
+	}
+}
+
+CURL4ESL_TEST(noStoreAndPrivateResponsesAreNotStored) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.headers.emplace_back("Cache-Control", request.path == "/private" ? "private, max-age=60" : "no-store, max-age=60");
+		response.headers.emplace_back("ETag", "\"v1\"");
+		response.body = request.path;
+		return response;
+	});
+	ConnectionFactory factory(createCacheSettings(server.getUrl(), 1024 * 1024));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	for(int i = 0; i < 2; ++i) {
+		CURL4ESL_CHECK_EQUAL(std::string("/private"), get(*connection, "/private"));
+		CURL4ESL_CHECK_EQUAL(std::string("/no-store"), get(*connection, "/no-store"));
+	}
+
+	std::vector<LoopbackServer::Request> requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(4u, requests.size());
+	for(const auto& request : requests) {
+		CURL4ESL_CHECK(request.findHeader("If-None-Match") == nullptr);
+	}
+}
+
+CURL4ESL_TEST(varyStoresOneVariantPerRequestValue) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.headers.emplace_back("Cache-Control", "max-age=60");
+		response.headers.emplace_back("Vary", "Accept-Language");
+		const std::string* language = request.findHeader("Accept-Language");
+		response.body = language ? *language : "none";
+		return response;
+	});
+	ConnectionFactory factory(createCacheSettings(server.getUrl(), 1024 * 1024));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	auto createRequest = [](const std::string& language) {
+		esl::com::http::client::Request request = TestUtility::createRequest("GET", "/");
+		request.addHeader("Accept-Language", language);
+		return request;
+	};
+
+	CURL4ESL_CHECK_EQUAL(std::string("en"), get(*connection, createRequest("en")));
+	CURL4ESL_CHECK_EQUAL(std::string("de"), get(*connection, createRequest("de")));
+	CURL4ESL_CHECK_EQUAL(std::string("en"), get(*connection, createRequest("en")));
+	CURL4ESL_CHECK_EQUAL(std::string("de"), get(*connection, createRequest("de")));
+	CURL4ESL_CHECK_EQUAL(std::string("none"), get(*connection, "/"));
+	CURL4ESL_CHECK_EQUAL(std::string("none"), get(*connection, "/"));
+
+	/* a value that has not been stored misses */
+	CURL4ESL_CHECK_EQUAL(std::string("fr"), get(*connection, createRequest("fr")));
+
+	CURL4ESL_CHECK_EQUAL(4u, server.getRequests().size());
+}
+
+CURL4ESL_TEST(leastRecentlyUsedEntryIsEvicted) {
+	/* an entry is a bit larger than the body, so four of them fit into the cache, but not five */
+	LoopbackServer server(createCacheable("max-age=60", std::string(800, 'c')));
+	ConnectionFactory factory(createCacheSettings(server.getUrl(), 4000));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	for(const char* path : { "/a", "/b", "/c", "/d" }) {
+		get(*connection, path);
+	}
+	CURL4ESL_CHECK_EQUAL(4u, server.getRequests().size());
+
+	/* '/a' becomes the most recently used entry, so '/b' gets evicted by '/e' */
+	get(*connection, "/a");
+	get(*connection, "/e");
+	get(*connection, "/a");
+	get(*connection, "/c");
+	get(*connection, "/b");
+
+	std::vector<LoopbackServer::Request> requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(6u, requests.size());
+	CURL4ESL_CHECK_EQUAL(std::string("/e"), requests[4].path);
+	CURL4ESL_CHECK_EQUAL(std::string("/b"), requests[5].path);
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,120 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Connection.h>
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+#include <esl/io/Output.h>
+#include <esl/io/Writer.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* the first response is '503 Service Unavailable' with a body */
+LoopbackServer::Handler createUnavailableOnce(std::atomic<int>& received) {
+	return [&received](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		if(received++ == 0) {
+			response.statusCode = 503;
+			response.body = "busy";
+		}
+		else {
+			response.body = "ok";
+		}
+		return response;
+	};
+}
+
+esl::com::http::client::CURLConnectionFactory::Settings createRetrySettings(const std::string& url) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(url);
+	settings.retryMaxAttempts = 2;
+	settings.retryBaseBackoff = 1;
+	return settings;
+}
+
+CURL4ESL_TEST(retryableStatusIsRetriedWithCreateInput) {
+	std::atomic<int> received(0);
+	LoopbackServer server(createUnavailableOnce(received));
+	ConnectionFactory factory(createRetrySettings(server.getUrl()));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(std::string("ok"), body);
+	CURL4ESL_CHECK_EQUAL(2, received.load());
+}
+
+CURL4ESL_TEST(retryableStatusIsRetriedWithInput) {
+	std::atomic<int> received(0);
+	LoopbackServer server(createUnavailableOnce(received));
+	ConnectionFactory factory(createRetrySettings(server.getUrl()));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	esl::io::Input input(std::unique_ptr<esl::io::Writer>(new TestUtility::StringWriter(body)));
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), std::move(input));
+
+	/* the body of the '503' response has not been passed to the input */
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(std::string("ok"), body);
+	CURL4ESL_CHECK_EQUAL(2, received.load());
+}
+
+CURL4ESL_TEST(retryableStatusOfPostIsNotRetried) {
+	std::atomic<int> received(0);
+	LoopbackServer server(createUnavailableOnce(received));
+	ConnectionFactory factory(createRetrySettings(server.getUrl()));
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	/* the body could be sent again, but the server might have processed the request already */
+	const std::string data(1000, 'p');
+	std::string body;
+	esl::com::http::client::Response response = connection.send(TestUtility::createRequest("POST", "/"), data.data(), data.size(), TestUtility::createStringInput(body));
+
+	CURL4ESL_CHECK_EQUAL(503, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(std::string("busy"), body);
+	CURL4ESL_CHECK_EQUAL(1, received.load());
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,256 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/SegmentedDownload.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* temporary file for a download, it is removed by the destructor */
+class TemporaryFile {
+public:
+	TemporaryFile() {
+		char pathTemplate[] = "/tmp/curl4esl-test-XXXXXX";
+		int fd = mkstemp(pathTemplate);
+		if(fd < 0) {
+			throw std::runtime_error("cannot create temporary file");
+		}
+		::close(fd);
+		path = pathTemplate;
+	}
+
+	~TemporaryFile() {
+		std::remove(path.c_str());
+	}
+
+	std::string read() const {
+		std::ifstream file(path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	std::string path;
+};
+
+std::string createContent(std::size_t size) {
+	std::string content(size, '\0');
+	for(std::size_t i = 0; i < size; ++i) {
+		content[i] = static_cast<char>((i * 131 + i / 251) & 0xff);
+	}
+	return content;
+}
+
+/* answers "Range: bytes=<first>-<last>" like a server supporting ranges, a request without range or
+ * with an If-Range that does not match 'etag' gets the whole content */
+LoopbackServer::Response createRangeResponse(const LoopbackServer::Request& request, const std::string& content, const std::string& etag) {
+	LoopbackServer::Response response;
+	response.headers.emplace_back("ETag", etag);
+
+	const std::string* range = request.findHeader("Range");
+	const std::string* ifRange = request.findHeader("If-Range");
+	if(!range || range->compare(0, 6, "bytes=") != 0 || (ifRange && *ifRange != etag)) {
+		response.body = content;
+		return response;
+	}
+
+	std::size_t first = std::strtoul(range->c_str() + 6, nullptr, 10);
+	std::size_t last = std::strtoul(range->c_str() + range->find('-') + 1, nullptr, 10);
+	if(first >= content.size()) {
+		response.statusCode = 416;
+		response.headers.emplace_back("Content-Range", "bytes */" + std::to_string(content.size()));
+		return response;
+	}
+	last = std::min(last, content.size() - 1);
+
+	response.statusCode = 206;
+	response.headers.emplace_back("Content-Range", "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(content.size()));
+	response.body = content.substr(first, last - first + 1);
+	return response;
+}
+
+/* first byte of the range requested, or npos */
+std::size_t getRangeFirst(const LoopbackServer::Request& request) {
+	const std::string* range = request.findHeader("Range");
+	return range ? std::strtoul(range->c_str() + 6, nullptr, 10) : std::string::npos;
+}
+
+esl::com::http::client::CURLConnectionFactory::Settings createDownloadSettings(const std::string& url) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(url);
+	settings.downloadMinSegmentSize = 64 * 1024;
+	settings.retryBaseBackoff = 1;
+	return settings;
+}
+
+CURL4ESL_TEST(segmentedDownloadIsIdentical) {
+	const std::string content = createContent(1024 * 1024 + 17);
+	LoopbackServer server([&content](const LoopbackServer::Request& request) {
+		return createRangeResponse(request, content, "\"v1\"");
+	});
+	ConnectionFactory factory(createDownloadSettings(server.getUrl()));
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+
+	TemporaryFile file;
+	SegmentedDownload::Result result = connection->download(TestUtility::createRequest("GET", "/file"), file.path, 4);
+
+	CURL4ESL_CHECK_EQUAL(content.size(), result.size);
+	CURL4ESL_CHECK_EQUAL(4u, result.segments);
+	CURL4ESL_CHECK_EQUAL(std::string("\"v1\""), result.etag);
+	CURL4ESL_CHECK(file.read() == content);
+
+	/* probe and one request per segment, each segment is bound to the ETag of the probe */
+	std::vector<LoopbackServer::Request> requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(5u, requests.size());
+	for(std::size_t i = 1; i < requests.size(); ++i) {
+		const std::string* ifRange = requests[i].findHeader("If-Range");
+		CURL4ESL_CHECK(ifRange != nullptr && *ifRange == "\"v1\"");
+	}
+}
+
+CURL4ESL_TEST(droppedSegmentIsResumedAtItsOffset) {
+	const std::string content = createContent(256 * 1024);
+	std::mutex mutex;
+	std::size_t droppedFirst = std::string::npos;
+	LoopbackServer server([&](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response = createRangeResponse(request, content, "\"v1\"");
+
+		/* the first segment in the second half of the file loses its connection after 1000 bytes */
+		std::size_t first = getRangeFirst(request);
+		std::lock_guard<std::mutex> lock(mutex);
+		if(droppedFirst == std::string::npos && first != std::string::npos && first >= content.size() / 2) {
+			droppedFirst = first;
+			response.truncateBody = 1000;
+		}
+		return response;
+	});
+	ConnectionFactory factory(createDownloadSettings(server.getUrl()));
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+
+	TemporaryFile file;
+	SegmentedDownload::Result result = connection->download(TestUtility::createRequest("GET", "/file"), file.path, 4);
+
+	CURL4ESL_CHECK_EQUAL(content.size(), result.size);
+	CURL4ESL_CHECK(file.read() == content);
+
+	std::vector<LoopbackServer::Request> requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(6u, requests.size());
+
+	std::size_t resumed = 0;
+	for(const auto& request : requests) {
+		if(getRangeFirst(request) == droppedFirst + 1000) {
+			++resumed;
+		}
+	}
+	CURL4ESL_CHECK_EQUAL(1u, resumed);
+}
+
+CURL4ESL_TEST(changedETagFailsDownload) {
+	const std::string content = createContent(256 * 1024);
+	std::atomic<int> received(0);
+	LoopbackServer server([&](const LoopbackServer::Request& request) {
+		/* the resource changes right after the probe */
+		return createRangeResponse(request, content, received++ == 0 ? "\"v1\"" : "\"v2\"");
+	});
+	ConnectionFactory factory(createDownloadSettings(server.getUrl()));
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+
+	TemporaryFile file;
+	bool failed = false;
+	try {
+		connection->download(TestUtility::createRequest("GET", "/file"), file.path, 4);
+	}
+	catch(const std::runtime_error& e) {
+		failed = std::string(e.what()).find("has been changed") != std::string::npos;
+	}
+	CURL4ESL_CHECK(failed);
+
+	/* a changed resource is not retried */
+	CURL4ESL_CHECK_EQUAL(5, received.load());
+}
+
+CURL4ESL_TEST(downloadWithoutRangeSupportIsSingleSegment) {
+	const std::string content = createContent(256 * 1024);
+	LoopbackServer server([&content](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		response.body = content;
+		return response;
+	});
+	ConnectionFactory factory(createDownloadSettings(server.getUrl()));
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+
+	TemporaryFile file;
+	SegmentedDownload::Result result = connection->download(TestUtility::createRequest("GET", "/file"), file.path, 4);
+
+	CURL4ESL_CHECK_EQUAL(content.size(), result.size);
+	CURL4ESL_CHECK_EQUAL(1u, result.segments);
+	CURL4ESL_CHECK(file.read() == content);
+	CURL4ESL_CHECK_EQUAL(1u, server.getRequests().size());
+}
+
+CURL4ESL_TEST(downloadOfEmptyResource) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		return createRangeResponse(request, std::string(), "\"v1\"");
+	});
+	ConnectionFactory factory(createDownloadSettings(server.getUrl()));
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+
+	TemporaryFile file;
+	{
+		std::ofstream stale(file.path, std::ios::binary);
+		stale << "stale content";
+	}
+	SegmentedDownload::Result result = connection->download(TestUtility::createRequest("GET", "/file"), file.path, 4);
+
+	CURL4ESL_CHECK_EQUAL(0u, result.size);
+	CURL4ESL_CHECK_EQUAL(1u, result.segments);
+	CURL4ESL_CHECK(file.read().empty());
+	CURL4ESL_CHECK_EQUAL(1u, server.getRequests().size());
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,199 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/HeaderStore.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/Send.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+#include <curl4esl/com/http/client/UploadFile.h>
+
+#include <esl/com/http/client/Connection.h>
+#include <esl/com/http/client/exception/NetworkError.h>
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+#include <esl/io/Output.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* temporary file with the given content, it is removed by the destructor */
+class TemporaryFile {
+public:
+	TemporaryFile(const std::string& content) {
+		char pathTemplate[] = "/tmp/curl4esl-test-XXXXXX";
+		int fd = mkstemp(pathTemplate);
+		if(fd < 0 || ::write(fd, content.data(), content.size()) != static_cast<ssize_t>(content.size())) {
+			throw std::runtime_error("cannot create temporary file");
+		}
+		::close(fd);
+		path = pathTemplate;
+	}
+
+	~TemporaryFile() {
+		std::remove(path.c_str());
+	}
+
+	std::string path;
+};
+
+CURL4ESL_TEST(sendWithoutBodyAfterBufferIsPlainGet) {
+	LoopbackServer server;
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	const std::string data = "payload";
+	std::string body;
+	connection.send(TestUtility::createRequest("POST", "/buffer"), data.data(), data.size(), TestUtility::createStringInput(body));
+
+	/* same connection, so the send uses the handle of the buffer send again */
+	auto begin = std::chrono::steady_clock::now();
+	connection.send(TestUtility::createRequest("GET", "/get"), esl::io::Output(), TestUtility::createStringInput(body));
+	auto duration = std::chrono::steady_clock::now() - begin;
+
+	auto requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(2u, requests.size());
+	CURL4ESL_CHECK_EQUAL(data, requests[0].body);
+
+	CURL4ESL_CHECK_EQUAL(std::string("GET"), requests[1].method);
+	CURL4ESL_CHECK(requests[1].body.empty());
+	CURL4ESL_CHECK(requests[1].findHeader("Transfer-Encoding") == nullptr);
+	CURL4ESL_CHECK(requests[1].findHeader("Content-Length") == nullptr);
+	CURL4ESL_CHECK(requests[1].findHeader("Expect") == nullptr);
+	/* libcurl waits up to a second for "100 Continue" before it sends a body */
+	CURL4ESL_CHECK(duration < std::chrono::milliseconds(500));
+}
+
+CURL4ESL_TEST(fileIsRewoundIfReusedConnectionIsDead) {
+	std::size_t uploads = 0;
+	LoopbackServer server([&uploads](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		/* the first upload is dropped, libcurl retries it on a new connection */
+		response.drop = request.method == "POST" && ++uploads == 1;
+		return response;
+	});
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	std::string body;
+	connection.send(TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body));
+
+	const std::string content(100000, 'f');
+	TemporaryFile file(content);
+	connection.send(TestUtility::createRequest("POST", "/file"), std::make_shared<UploadFile>(file.path), TestUtility::createStringInput(body));
+
+	auto requests = server.getRequests();
+	CURL4ESL_CHECK_EQUAL(3u, requests.size());
+	CURL4ESL_CHECK_EQUAL(content, requests[2].body);
+}
+
+CURL4ESL_TEST(streamedBodyIsNotRewoundWithSeekDataOfPreviousSend) {
+	std::size_t uploads = 0;
+	LoopbackServer server([&uploads](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.drop = request.path == "/stream" && ++uploads == 1;
+		return response;
+	});
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	std::string body;
+	TemporaryFile file(std::string(1000, 'f'));
+	connection.send(TestUtility::createRequest("POST", "/file"), std::make_shared<UploadFile>(file.path), TestUtility::createStringInput(body));
+
+	/* A streamed body cannot be rewound, so the retry of libcurl must fail instead of seeking the file of the previous send.
+	 * Its size is announced, so libcurl does not wait for "100 Continue" and retries the dropped request. */
+	bool failed = false;
+	try {
+		connection.send(TestUtility::createRequest("POST", "/stream"), TestUtility::createGeneratedOutput(1000, 100, true), TestUtility::createStringInput(body));
+	}
+	catch(const esl::com::http::client::exception::NetworkError& e) {
+		failed = std::string(e.what()).find("=" + std::to_string(CURLE_SEND_FAIL_REWIND) + " ") != std::string::npos;
+	}
+	CURL4ESL_CHECK(failed);
+}
+
+CURL4ESL_TEST(uploadBufferOfFileIsNotKeptForOtherBodies) {
+	std::shared_ptr<HandlePool> handlePool = std::make_shared<HandlePool>(TestUtility::createSettings("http://127.0.0.1"));
+	HandlePool::HandlePtr handle = handlePool->acquire();
+	PreparedRequest request("http://127.0.0.1", TestUtility::createRequest("POST", "/"));
+
+	TemporaryFile file("content");
+	{
+		Send send(*handle, request, Body(std::make_shared<UploadFile>(file.path)), esl::io::Input());
+		CURL4ESL_CHECK(handle->uploadBufferSize > 1024 * 1024);
+	}
+
+	const char data[] = "data";
+	{
+		Send send(*handle, request, Body(data, sizeof(data)), esl::io::Input());
+		CURL4ESL_CHECK_EQUAL(0, handle->uploadBufferSize);
+	}
+}
+
+CURL4ESL_TEST(allSetCookieValuesReachResponse) {
+	LoopbackServer server([](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		response.headers.emplace_back("Set-Cookie", "a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT");
+		response.headers.emplace_back("Set-Cookie", "b=2");
+		return response;
+	});
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/"), esl::io::Output(), esl::io::Input());
+
+	const std::string* setCookie = HeaderStore::find(response.getHeaders(), "Set-Cookie");
+	CURL4ESL_CHECK(setCookie != nullptr);
+
+	std::vector<std::string> values = HeaderStore::splitSetCookie(*setCookie);
+	CURL4ESL_CHECK_EQUAL(2u, values.size());
+	CURL4ESL_CHECK_EQUAL(std::string("a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT"), values[0]);
+	CURL4ESL_CHECK_EQUAL(std::string("b=2"), values[1]);
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
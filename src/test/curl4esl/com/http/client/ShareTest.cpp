@@ -0,0 +1,74 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Body.h>
+#include <curl4esl/com/http/client/HandlePool.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/PreparedRequest.h>
+#include <curl4esl/com/http/client/Send.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Response.h>
+
+#include <memory>
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+CURL4ESL_TEST(tlsSessionIsResumedByOtherHandle) {
+	LoopbackServer server(nullptr, LoopbackServer::Scheme::https);
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.skipSSLVerification = true;
+	std::shared_ptr<HandlePool> handlePool = std::make_shared<HandlePool>(settings);
+	PreparedRequest request(settings.url, TestUtility::createRequest("GET", "/"));
+
+	/* both handles are in use at the same time, so the second one does not take over the connection of the first one */
+	HandlePool::HandlePtr first = handlePool->acquire();
+	HandlePool::HandlePtr second = handlePool->acquire();
+	{
+		std::string body;
+		Send send(*first, request, Body(), TestUtility::createStringInput(body));
+		CURL4ESL_CHECK_EQUAL(200, send.execute().getStatusCode());
+	}
+	{
+		std::string body;
+		Send send(*second, request, Body(), TestUtility::createStringInput(body));
+		CURL4ESL_CHECK_EQUAL(200, send.execute().getStatusCode());
+	}
+
+	CURL4ESL_CHECK_EQUAL(2u, server.getConnections());
+	CURL4ESL_CHECK_EQUAL(2u, server.getHandshakes());
+	CURL4ESL_CHECK_EQUAL(1u, server.getResumedHandshakes());
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
@@ -0,0 +1,255 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/SocketEngine.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Response.h>
+#include <esl/com/http/client/exception/NetworkError.h>
+#include <esl/io/Input.h>
+#include <esl/io/Output.h>
+
+#include <curl/curl.h>
+
+#include <poll.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* minimal event loop based on poll(), like an application would drive the engine */
+class PollLoop {
+public:
+	PollLoop(const ConnectionFactory& factory)
+	: engine(factory.createSocketEngine(
+			[this](curl_socket_t socket, int events) {
+				if(events == 0) {
+					sockets.erase(socket);
+				}
+				else {
+					sockets[socket] = events;
+				}
+			},
+			[this](long timeoutMs) {
+				hasDeadline = timeoutMs >= 0;
+				deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeoutMs, 0L));
+			}))
+	{ }
+
+	/* runs until 'isDone' returns true, returns false if it does not within 'timeout' */
+	bool run(const std::function<bool ()>& isDone, std::chrono::milliseconds timeout) {
+		auto end = std::chrono::steady_clock::now() + timeout;
+
+		while(!isDone()) {
+			auto now = std::chrono::steady_clock::now();
+			if(now > end) {
+				return false;
+			}
+
+			std::vector<pollfd> fds;
+			for(const auto& socket : sockets) {
+				pollfd fd;
+				fd.fd = socket.first;
+				fd.events = static_cast<short>(((socket.second & SocketEngine::eventIn) ? POLLIN : 0) | ((socket.second & SocketEngine::eventOut) ? POLLOUT : 0));
+				fd.revents = 0;
+				fds.push_back(fd);
+			}
+
+			long waitMs = 100;
+			if(hasDeadline) {
+				waitMs = std::min<long>(waitMs, std::max<long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()));
+			}
+
+			if(::poll(fds.data(), fds.size(), static_cast<int>(waitMs)) > 0) {
+				for(const auto& fd : fds) {
+					int events = ((fd.revents & (POLLIN | POLLHUP)) ? SocketEngine::eventIn : 0)
+							| ((fd.revents & POLLOUT) ? SocketEngine::eventOut : 0)
+							| ((fd.revents & POLLERR) ? SocketEngine::eventError : 0);
+					if(events != 0) {
+						engine->onSocket(fd.fd, events);
+					}
+				}
+			}
+
+			if(hasDeadline && std::chrono::steady_clock::now() >= deadline) {
+				hasDeadline = false;
+				engine->onTimeout();
+			}
+		}
+
+		return true;
+	}
+
+	std::map<curl_socket_t, int> sockets;
+	bool hasDeadline = false;
+	std::chrono::steady_clock::time_point deadline;
+
+	/* destroyed first, it may report the removal of sockets */
+	std::unique_ptr<SocketEngine> engine;
+};
+
+/* records the result of a transfer */
+struct Result {
+	bool done = false;
+	int statusCode = 0;
+	std::exception_ptr exceptionPtr;
+
+	Connection::Completion createCompletion() {
+		return [this](const esl::com::http::client::Response* response, std::exception_ptr aExceptionPtr) {
+			done = true;
+			statusCode = response ? response->getStatusCode() : 0;
+			exceptionPtr = aExceptionPtr;
+		};
+	}
+};
+
+CURL4ESL_TEST(socketEngineCompletesGetAndChunkedUpload) {
+	LoopbackServer server([](const LoopbackServer::Request& request) {
+		LoopbackServer::Response response;
+		response.body = request.method == "GET" ? "hello" : std::to_string(request.body.size());
+		return response;
+	});
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+	PollLoop loop(factory);
+
+	Result getResult;
+	std::string getBody;
+	connection->sendAsync(*loop.engine, TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(getBody), getResult.createCompletion());
+
+	Result uploadResult;
+	std::string uploadBody;
+	connection->sendAsync(*loop.engine, TestUtility::createRequest("POST", "/upload"), TestUtility::createGeneratedOutput(1024 * 1024, 64 * 1024), TestUtility::createStringInput(uploadBody), uploadResult.createCompletion());
+
+	CURL4ESL_CHECK(loop.run([&] {
+		return getResult.done && uploadResult.done;
+	}, std::chrono::seconds(10)));
+
+	CURL4ESL_CHECK(!getResult.exceptionPtr);
+	CURL4ESL_CHECK_EQUAL(200, getResult.statusCode);
+	CURL4ESL_CHECK_EQUAL(std::string("hello"), getBody);
+
+	CURL4ESL_CHECK(!uploadResult.exceptionPtr);
+	CURL4ESL_CHECK_EQUAL(200, uploadResult.statusCode);
+	CURL4ESL_CHECK_EQUAL(std::to_string(1024 * 1024), uploadBody);
+
+	CURL4ESL_CHECK_EQUAL(0u, loop.engine->getRunning());
+
+	bool chunked = false;
+	for(const auto& request : server.getRequests()) {
+		if(request.method == "POST") {
+			chunked = request.chunked;
+		}
+	}
+	CURL4ESL_CHECK(chunked);
+}
+
+CURL4ESL_TEST(socketEngineDrainsStalledWriter) {
+	std::shared_ptr<const std::string> body = std::make_shared<const std::string>(1024 * 1024, 'x');
+	LoopbackServer server([body](const LoopbackServer::Request&) {
+		LoopbackServer::Response response;
+		response.sharedBody = body;
+		return response;
+	});
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.maxReceiveBuffer = 64 * 1024;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+	PollLoop loop(factory);
+
+	/* the writer takes 4 KiB per call and stalls every third call, so the transfer gets paused and resumed */
+	Result result;
+	std::size_t written = 0;
+	connection->sendAsync(*loop.engine, TestUtility::createRequest("GET", "/"), esl::io::Output(), [&written](const esl::com::http::client::Response&) {
+		return esl::io::Input(std::unique_ptr<esl::io::Writer>(new TestUtility::ThrottledWriter(written, 4096, 3)));
+	}, result.createCompletion());
+
+	CURL4ESL_CHECK(loop.run([&result] {
+		return result.done;
+	}, std::chrono::seconds(10)));
+
+	CURL4ESL_CHECK(!result.exceptionPtr);
+	CURL4ESL_CHECK_EQUAL(200, result.statusCode);
+	CURL4ESL_CHECK_EQUAL(body->size(), written);
+}
+
+CURL4ESL_TEST(socketEngineAbortsRunningTransfersOnDestruction) {
+	std::atomic<bool> received(false);
+	LoopbackServer server([&received](const LoopbackServer::Request&) {
+		received = true;
+		LoopbackServer::Response response;
+		response.delay = std::chrono::milliseconds(500);
+		return response;
+	});
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> connection = factory.createNativeConnection();
+	PollLoop loop(factory);
+
+	Result result;
+	std::string body;
+	connection->sendAsync(*loop.engine, TestUtility::createRequest("GET", "/"), esl::io::Output(), TestUtility::createStringInput(body), result.createCompletion());
+
+	CURL4ESL_CHECK(loop.run([&received] {
+		return received.load();
+	}, std::chrono::seconds(10)));
+	CURL4ESL_CHECK(!result.done);
+	CURL4ESL_CHECK_EQUAL(1u, loop.engine->getRunning());
+
+	loop.engine.reset();
+
+	CURL4ESL_CHECK(result.done);
+	CURL4ESL_CHECK(result.exceptionPtr);
+
+	bool aborted = false;
+	try {
+		std::rethrow_exception(result.exceptionPtr);
+	}
+	catch(const esl::com::http::client::exception::NetworkError& e) {
+		aborted = std::string(e.what()).find("=" + std::to_string(CURLE_ABORTED_BY_CALLBACK) + " ") != std::string::npos;
+	}
+	CURL4ESL_CHECK(aborted);
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
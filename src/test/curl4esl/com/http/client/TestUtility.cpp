@@ -0,0 +1,126 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/utility/HttpMethod.h>
+#include <esl/utility/MIME.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+TestUtility::StringWriter::StringWriter(std::string& aTarget)
+: target(aTarget)
+{ }
+
+std::size_t TestUtility::StringWriter::write(const void* data, std::size_t size) {
+	target.append(static_cast<const char*>(data), size);
+	return size;
+}
+
+std::size_t TestUtility::StringWriter::getSizeWritable() const {
+	return npos;
+}
+
+TestUtility::ThrottledWriter::ThrottledWriter(std::size_t& aWritten, std::size_t aMaxSize, std::size_t aStallEvery)
+: written(aWritten),
+  maxSize(aMaxSize),
+  stallEvery(aStallEvery)
+{ }
+
+std::size_t TestUtility::ThrottledWriter::write(const void*, std::size_t size) {
+	++calls;
+	if(stallEvery > 0 && calls % stallEvery == 0) {
+		return 0;
+	}
+
+	size = std::min(size, maxSize);
+	written += size;
+	return size;
+}
+
+std::size_t TestUtility::ThrottledWriter::getSizeWritable() const {
+	return maxSize;
+}
+
+TestUtility::GeneratedReader::GeneratedReader(std::size_t aSize, std::size_t aPieceSize, bool aAnnounceSize)
+: size(aSize),
+  remaining(aSize),
+  pieceSize(aPieceSize),
+  announceSize(aAnnounceSize)
+{ }
+
+std::size_t TestUtility::GeneratedReader::read(void* data, std::size_t dataSize) {
+	if(remaining == 0) {
+		return npos;
+	}
+
+	dataSize = std::min(std::min(dataSize, pieceSize), remaining);
+	std::memset(data, 'x', dataSize);
+	remaining -= dataSize;
+	return dataSize;
+}
+
+std::size_t TestUtility::GeneratedReader::getSizeReadable() const {
+	return std::min(remaining, pieceSize);
+}
+
+bool TestUtility::GeneratedReader::hasSize() const {
+	return announceSize;
+}
+
+std::size_t TestUtility::GeneratedReader::getSize() const {
+	return announceSize ? size : npos;
+}
+
+esl::com::http::client::Request TestUtility::createRequest(const std::string& method, const std::string& path) {
+	return esl::com::http::client::Request(path, esl::utility::HttpMethod(method), esl::utility::MIME());
+}
+
+esl::com::http::client::CURLConnectionFactory::Settings TestUtility::createSettings(const std::string& url) {
+	esl::com::http::client::CURLConnectionFactory::Settings settings;
+	settings.url = url;
+	return settings;
+}
+
+std::function<esl::io::Input (const esl::com::http::client::Response&)> TestUtility::createStringInput(std::string& body) {
+	return [&body](const esl::com::http::client::Response&) {
+		return esl::io::Input(std::unique_ptr<esl::io::Writer>(new StringWriter(body)));
+	};
+}
+
+esl::io::Output TestUtility::createGeneratedOutput(std::size_t size, std::size_t pieceSize, bool announceSize) {
+	return esl::io::Output(std::unique_ptr<esl::io::Reader>(new GeneratedReader(size, pieceSize, announceSize)));
+}
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
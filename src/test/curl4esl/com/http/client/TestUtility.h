@@ -0,0 +1,108 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CURL4ESL_COM_HTTP_CLIENT_TESTUTILITY_H_
+#define CURL4ESL_COM_HTTP_CLIENT_TESTUTILITY_H_
+
+#include <esl/com/http/client/CURLConnectionFactory.h>
+#include <esl/com/http/client/Request.h>
+#include <esl/com/http/client/Response.h>
+#include <esl/io/Input.h>
+#include <esl/io/Output.h>
+#include <esl/io/Reader.h>
+#include <esl/io/Writer.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+/* Helpers shared by tests and benchmarks */
+class TestUtility {
+public:
+	/* appends all data to a string */
+	class StringWriter : public esl::io::Writer {
+	public:
+		StringWriter(std::string& target);
+
+		std::size_t write(const void* data, std::size_t size) override;
+		std::size_t getSizeWritable() const override;
+
+	private:
+		std::string& target;
+	};
+
+	/* Takes at most 'maxSize' bytes per call and returns 0 for every 'stallEvery'-th call,
+	 * like a writer that cannot keep up with the network. 0 for 'stallEvery' never stalls. */
+	class ThrottledWriter : public esl::io::Writer {
+	public:
+		ThrottledWriter(std::size_t& written, std::size_t maxSize, std::size_t stallEvery);
+
+		std::size_t write(const void* data, std::size_t size) override;
+		std::size_t getSizeWritable() const override;
+
+	private:
+		std::size_t& written;
+		std::size_t maxSize;
+		std::size_t stallEvery;
+		std::size_t calls = 0;
+	};
+
+	/* Produces 'size' bytes in pieces of at most 'pieceSize'. If the size is not announced, the body is sent chunked. */
+	class GeneratedReader : public esl::io::Reader {
+	public:
+		GeneratedReader(std::size_t size, std::size_t pieceSize, bool announceSize);
+
+		std::size_t read(void* data, std::size_t size) override;
+		std::size_t getSizeReadable() const override;
+		bool hasSize() const override;
+		std::size_t getSize() const override;
+
+	private:
+		std::size_t size;
+		std::size_t remaining;
+		std::size_t pieceSize;
+		bool announceSize;
+	};
+
+	static esl::com::http::client::Request createRequest(const std::string& method, const std::string& path);
+
+	static esl::com::http::client::CURLConnectionFactory::Settings createSettings(const std::string& url);
+
+	/* 'createInput' for send(...) that stores the body of the response in 'body' */
+	static std::function<esl::io::Input (const esl::com::http::client::Response&)> createStringInput(std::string& body);
+
+	static esl::io::Output createGeneratedOutput(std::size_t size, std::size_t pieceSize, bool announceSize = false);
+};
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */
+
+#endif /* CURL4ESL_COM_HTTP_CLIENT_TESTUTILITY_H_ */
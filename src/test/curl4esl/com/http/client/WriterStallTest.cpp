@@ -0,0 +1,246 @@
+/*
+MIT License
+Copyright (c) 2019-2023 Sven Lukas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <curl4esl/Test.h>
+#include <curl4esl/com/http/client/Connection.h>
+#include <curl4esl/com/http/client/ConnectionFactory.h>
+#include <curl4esl/com/http/client/LoopbackServer.h>
+#include <curl4esl/com/http/client/TestUtility.h>
+
+#include <esl/com/http/client/Connection.h>
+#include <esl/com/http/client/Response.h>
+#include <esl/com/http/client/exception/NetworkError.h>
+#include <esl/io/Input.h>
+#include <esl/io/Output.h>
+#include <esl/io/Writer.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace curl4esl {
+inline namespace v1_6 {
+namespace com {
+namespace http {
+namespace client {
+
+namespace {
+/* takes no data until it gets opened */
+class GateWriter : public esl::io::Writer {
+public:
+	GateWriter(const std::atomic<bool>& aOpen, std::string& aTarget)
+	: open(aOpen),
+	  target(aTarget)
+	{ }
+
+	std::size_t write(const void* data, std::size_t size) override {
+		if(!open) {
+			return 0;
+		}
+		target.append(static_cast<const char*>(data), size);
+		return size;
+	}
+
+	std::size_t getSizeWritable() const override {
+		return open ? npos : 0;
+	}
+
+private:
+	const std::atomic<bool>& open;
+	std::string& target;
+};
+
+std::function<esl::io::Input (const esl::com::http::client::Response&)> createGateInput(const std::atomic<bool>& open, std::string& body) {
+	return [&open, &body](const esl::com::http::client::Response&) {
+		return esl::io::Input(std::unique_ptr<esl::io::Writer>(new GateWriter(open, body)));
+	};
+}
+
+LoopbackServer::Response createBody(const LoopbackServer::Request& request) {
+	LoopbackServer::Response response;
+	if(request.path == "/body") {
+		response.body = std::string(100000, 'b');
+	}
+	else if(request.path == "/cached") {
+		response.headers.emplace_back("Cache-Control", "max-age=60");
+		response.body = std::string(100000, 'c');
+	}
+	return response;
+}
+
+CURL4ESL_TEST(stalledWriterGetsQueuedDataAfterTransfer) {
+	LoopbackServer server(createBody);
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::atomic<bool> open(false);
+	std::thread opener([&open] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		open = true;
+	});
+
+	std::string body;
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/body"), esl::io::Output(), createGateInput(open, body));
+	opener.join();
+
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(100000u, body.size());
+}
+
+CURL4ESL_TEST(stalledWriterIsGivenUp) {
+	LoopbackServer server(createBody);
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.writerStallTimeout = 100;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::atomic<bool> open(false);
+	std::string body;
+	auto begin = std::chrono::steady_clock::now();
+	bool failed = false;
+	try {
+		connection->send(TestUtility::createRequest("GET", "/body"), esl::io::Output(), createGateInput(open, body));
+	}
+	catch(const esl::com::http::client::exception::NetworkError&) {
+		failed = true;
+	}
+
+	CURL4ESL_CHECK(failed);
+	CURL4ESL_CHECK(std::chrono::steady_clock::now() - begin < std::chrono::seconds(2));
+}
+
+CURL4ESL_TEST(stalledWriterDoesNotBlockEventLoop) {
+	LoopbackServer server(createBody);
+	ConnectionFactory factory(TestUtility::createSettings(server.getUrl()));
+	std::unique_ptr<Connection> nativeConnection = factory.createNativeConnection();
+	Connection& connection = *nativeConnection;
+
+	std::atomic<bool> open(false);
+	std::string stalledBody;
+	std::future<esl::com::http::client::Response> stalled = connection.sendAsync(TestUtility::createRequest("GET", "/body"), esl::io::Output(), createGateInput(open, stalledBody));
+
+	/* completes while the writer of the first transfer is stalled */
+	std::string body;
+	std::future<esl::com::http::client::Response> other = connection.sendAsync(TestUtility::createRequest("GET", "/body"), esl::io::Output(), TestUtility::createStringInput(body));
+	CURL4ESL_CHECK(other.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+	CURL4ESL_CHECK_EQUAL(100000u, body.size());
+	CURL4ESL_CHECK(stalled.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready);
+
+	open = true;
+	CURL4ESL_CHECK(stalled.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+	CURL4ESL_CHECK_EQUAL(200, stalled.get().getStatusCode());
+	CURL4ESL_CHECK_EQUAL(100000u, stalledBody.size());
+}
+
+CURL4ESL_TEST(stalledWriterOfPipelineGetsData) {
+	LoopbackServer server(createBody);
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.pipelineDepth = 2;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::atomic<bool> open(false);
+	std::thread opener([&open] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		open = true;
+	});
+
+	std::string body;
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/body"), esl::io::Output(), createGateInput(open, body));
+	opener.join();
+
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(100000u, body.size());
+}
+
+CURL4ESL_TEST(stalledWriterOfPipelineIsGivenUp) {
+	LoopbackServer server(createBody);
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.pipelineDepth = 2;
+	settings.writerStallTimeout = 100;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::atomic<bool> open(false);
+	std::string body;
+	auto begin = std::chrono::steady_clock::now();
+	bool failed = false;
+	try {
+		connection->send(TestUtility::createRequest("GET", "/body"), esl::io::Output(), createGateInput(open, body));
+	}
+	catch(const esl::com::http::client::exception::NetworkError&) {
+		failed = true;
+	}
+
+	CURL4ESL_CHECK(failed);
+	CURL4ESL_CHECK(std::chrono::steady_clock::now() - begin < std::chrono::seconds(2));
+}
+
+CURL4ESL_TEST(stalledWriterOfCachedResponse) {
+	LoopbackServer server(createBody);
+	server.setRecording(true);
+	esl::com::http::client::CURLConnectionFactory::Settings settings = TestUtility::createSettings(server.getUrl());
+	settings.cacheSize = 1000000;
+	settings.writerStallTimeout = 100;
+	ConnectionFactory factory(settings);
+	std::unique_ptr<esl::com::http::client::Connection> connection = factory.createConnection();
+
+	std::string body;
+	connection->send(TestUtility::createRequest("GET", "/cached"), esl::io::Output(), TestUtility::createStringInput(body));
+	CURL4ESL_CHECK_EQUAL(100000u, body.size());
+
+	/* replayed from the cache and given up */
+	std::atomic<bool> open(false);
+	std::string stalledBody;
+	auto begin = std::chrono::steady_clock::now();
+	bool failed = false;
+	try {
+		connection->send(TestUtility::createRequest("GET", "/cached"), esl::io::Output(), createGateInput(open, stalledBody));
+	}
+	catch(const esl::com::http::client::exception::NetworkError&) {
+		failed = true;
+	}
+	CURL4ESL_CHECK(failed);
+	CURL4ESL_CHECK(std::chrono::steady_clock::now() - begin < std::chrono::seconds(2));
+
+	/* replayed from the cache after the writer has been stalled for a while */
+	std::thread opener([&open] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		open = true;
+	});
+	esl::com::http::client::Response response = connection->send(TestUtility::createRequest("GET", "/cached"), esl::io::Output(), createGateInput(open, stalledBody));
+	opener.join();
+
+	CURL4ESL_CHECK_EQUAL(200, response.getStatusCode());
+	CURL4ESL_CHECK_EQUAL(100000u, stalledBody.size());
+	CURL4ESL_CHECK_EQUAL(1u, server.getRequests().size());
+}
+}  // anonymer namespace
+
+} /* namespace client */
+} /* namespace http */
+} /* namespace com */
+} /* inline namespace v1_6 */
+} /* namespace curl4esl */